@@ -110,6 +110,7 @@ Script: [
 	wrong-denom:        [:arg1 {not same denomination as} :arg2]
 ;   bad-convert:        [{invalid conversion value:} :arg1]
 	bad-press:          [{invalid compressed data - problem:} :arg1]
+	bad-serial:         {invalid or incompatible serialized data}
 	dialect:            [{incorrect} :arg1 {dialect usage at:} :arg2]
 	bad-command:        {invalid command format (extension function)}
 
@@ -162,6 +163,7 @@ Access: [
 	read-only:          [{read-only - write not allowed:} :arg1]
 	no-buffer:          [{port has no data buffer:} :arg1]
 	timeout:            [{port action timed out:} :arg1]
+	port-busy:          [{port has a request pending:} :arg1]
 
 	no-create:          [{cannot create:} :arg1]
 	no-delete:          [{cannot delete:} :arg1]
@@ -380,7 +380,7 @@ checksum: native [
 	/hash {Returns a hash value}
 	size [integer!] {Size of the hash table}
 	/method {Method to use}
-	word [word!] {Methods: SHA1 MD5 CRC32}
+	word [word!] {Methods: SHA1 SHA256 MD5 CRC32 CRC32C}
 	/key {Returns keyed HMAC value}
 	key-value [any-string!] {Key to use}
 ]
@@ -400,6 +400,17 @@ decompress: native [
 	/limit size {Error out if result is larger than this}
 ]
 
+serialize: native [
+	{Encodes a value as binary data, for fast saving. (See: deserialize)}
+	value [any-type!]
+]
+
+deserialize: native [
+	{Decodes a value from binary data made by serialize.}
+	data [binary!]
+	/mapped {Use a mapped file's memory in place (the binary is emptied)}
+]
+
 construct: native [
 	{Creates an object with scant (safe) evaluation.}
 	block [block! string! binary!] "Specification (modified)"
@@ -412,6 +423,7 @@ debase: native [
 	value [binary! string!] {The string to decode}
 	/base {Binary base to use}
 	base-value [integer!] {The base to convert from: 64, 16, or 2}
+	/url {Base-64 uses the URL and filename safe alphabet (- and _), padding optional}
 ]
 
 enbase: native [
@@ -419,6 +431,7 @@ enbase: native [
 	value [binary! string!] {If string, will be UTF8 encoded}
 	/base {Binary base to use}
 	base-value [integer!] {The base to convert to: 64, 16, or 2}
+	/url {Base-64 uses the URL and filename safe alphabet (- and _), no padding}
 ]
 
 decloak: native [
@@ -441,6 +454,20 @@ deline: native [
 	/lines "Return block of lines (works for LF, CR, CR-LF endings) (no modify)"
 ]
 
+split: native [
+	{Split a series into pieces; fixed or variable size, fixed number, or at delimiters.}
+	series [series!] {The series to split}
+	dlm [block! integer! char! bitset! any-string! binary!] {Split size, delimiter(s), or rule(s)}
+	/into {If dlm is an integer, split into n pieces, rather than pieces of length n}
+	/positions {Return the head and tail index of each piece, not copies}
+]
+
+split-lines: native [
+	{Splits a string into lines at LF, CR, or CR-LF endings.}
+	string [any-string! binary!]
+	/positions {Return the head and tail index of each line, not copies}
+]
+
 enline: native [
 	"Converts string terminators to native OS format, e.g. LF to CRLF."
 	series [any-string! block!] {(modified)}
@@ -547,10 +574,11 @@ in: native [
 
 parse: native [
 	{Parses a string or block series according to grammar rules.}
-	input [series!] {Input series to parse}
+	input [series! port!] {Input series to parse (or open port, read as binary)}
 	rules [block! string! char! none!] {Rules to parse by (none = ",;")}
 	/all {For simple rules (not blocks) parse all chars including whitespace}
 	/case {Uses case-sensitive comparison}
+	/memo {Remember sub-rule results at each position (for backtracking rules without actions)}
 ]
 
 set: native [
@@ -652,6 +680,7 @@ transcode: native [
 	/next "Translate next complete value (blocks as single value)"
 	/only "Translate only a single value (blocks dissected)"
 	/error "Do not cause errors - return error object as value in place"
+	/parallel "Tokenize large sources ahead on worker threads"
 ]
 
 echo: native [
@@ -931,7 +960,9 @@ do-codec: native [
 	{Evaluate a CODEC function to encode or decode media types.}
 	handle [handle!] "Internal link to codec"
 	action [word!] "Decode, encode, identify"
-	data [binary! image!]
+	data [binary! image! block! map! object! string!]
+	/options "Options for the codec"
+	opts [block!]
 ]
 
 set-scheme: native [
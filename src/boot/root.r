@@ -28,4 +28,5 @@ noneval			; NONE value
 noname			; noname function word
 
 boot			; boot block defined in boot.r (GC'd after boot is done)
+file-jobs		; ports, states and data of async file requests (GC protection)
 
@@ -225,6 +225,15 @@ standard: context [
 		port-id: 80
 			none
 	]
+
+	port-spec-zip: make port-spec-head [
+		level: none		; 0 - 9, or none for the zlib default
+		format: none	; zlib, gzip, deflate (raw), or none (auto on decompress)
+	]
+
+	port-spec-checksum: make port-spec-head [
+		method: none	; as CHECKSUM/method (none is sha1)
+	]
 	
 	file-info: context [
 		name:
@@ -265,6 +274,8 @@ standard: context [
 		made-blocks:
 		made-objects:
 		recycles:
+		parse-memo-hits:	; PARSE/memo sub-rule results reused
+		parse-memo-misses:
 			none
 	]
 
@@ -144,15 +144,25 @@ shift
 
 ; Checksum
 sha1
+sha256
 md4
 md5
 crc32
+crc32c
 
 ; Codec actions
 identify
 decode
 encode
 
+; Codec options
+columns
+strings
+more
+object
+lines
+items
+
 ; Schemes
 console
 file
@@ -163,6 +173,14 @@ dns
 tcp
 udp
 clipboard
+compress
+decompress
+checksum
+
+; Compression formats
+zlib
+gzip
+deflate
 
 ; Gobs:
 gob
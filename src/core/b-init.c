@@ -720,6 +720,8 @@ extern const REBYTE Str_Banner[];
 	Init_GIF_Codec();
 	Init_PNG_Codec();
 	Init_JPEG_Codec();
+	Init_CSV_Codec();
+	Init_JSON_Codec();
 }
 
 
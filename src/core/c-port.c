@@ -511,7 +511,7 @@ xx*/	REBINT Wait_Device(REBREQ *req, REBCNT timeout)
 **
 ***********************************************************************/
 
-#define MAX_SCHEMES 10		// max native schemes
+#define MAX_SCHEMES 16		// max native schemes
 
 typedef struct rebol_scheme_actions {
 	REBCNT sym;
@@ -624,7 +624,10 @@ SCHEME_ACTIONS *Scheme_Actions;	// Initial Global (not threaded)
 	Init_Dir_Scheme();
 	Init_Event_Scheme();
 	Init_TCP_Scheme();
+	Init_UDP_Scheme();
 	Init_DNS_Scheme();
+	Init_Compress_Scheme();
+	Init_Checksum_Scheme();
 #ifndef MIN_OS
 	Init_Clipboard_Scheme();
 #endif
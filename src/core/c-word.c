@@ -195,7 +195,23 @@
 **
 ***********************************************************************/
 {
-	REBINT	hash;
+	if (len == 0) len = LEN_BYTES(str);
+
+	return Make_Word_Hash(str, len, Hash_Word(str, len));
+}
+
+
+/***********************************************************************
+**
+*/	REBCNT Make_Word_Hash(REBYTE *str, REBCNT len, REBINT hash)
+/*
+**		Same as Make_Word, but given the Hash_Word of the string.
+**		Hash_Word is thread safe, so the scanner's workers compute
+**		it ahead (see load/parallel). The word table itself must
+**		only be changed here, by the interpreter's thread.
+**
+***********************************************************************/
+{
 	REBINT	size;
 	REBINT	skip;
 	REBINT	n;
@@ -206,8 +222,6 @@
 
 	//REBYTE *sss = Get_Sym_Name(1);	// (Debugging method)
 
-	if (len == 0) len = LEN_BYTES(str);
-
 	// If hash part of word table is too dense, expand it:
 	if (PG_Word_Table.series->tail > PG_Word_Table.hashes->tail/2)
 		Expand_Word_Table();
@@ -227,8 +241,7 @@
 	words  = BLK_HEAD(PG_Word_Table.series);
 	hashes = (REBCNT *)PG_Word_Table.hashes->data;
 
-	// Hash the word, including a skip factor for lookup:
-	hash  = Hash_Word(str, len);
+	// Use the word hash, including a skip factor for lookup:
 	skip  = (hash & 0x0000FFFF) % size;
 	if (skip == 0) skip = 1;
 	hash = (hash & 0x00FFFF00) % size;
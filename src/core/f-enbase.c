@@ -29,6 +29,7 @@
 
 #include "sys-core.h"
 #include "sys-scan.h"
+#include "sys-simd.h"
 
 
 /***********************************************************************
@@ -172,6 +173,122 @@
 };
 
 
+/***********************************************************************
+**
+*/	static const REBYTE Enbase64_URL[64] =
+/*
+**		Base-64 URL and filename safe encoder table (RFC 4648).
+**
+***********************************************************************/
+{
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+	"abcdefghijklmnopqrstuvwxyz"
+	"0123456789-_"
+};
+
+
+#ifdef USE_SSE2
+
+// Value of each hex digit char, or -1 in any byte that is not one:
+#define HEX_VALUES(v, out) { \
+	__m128i d_ = _mm_and_si128(_mm_cmpgt_epi8(v, SPLAT('0' - 1)), _mm_cmplt_epi8(v, SPLAT('9' + 1))); \
+	__m128i u_ = _mm_and_si128(_mm_cmpgt_epi8(v, SPLAT('A' - 1)), _mm_cmplt_epi8(v, SPLAT('F' + 1))); \
+	__m128i l_ = _mm_and_si128(_mm_cmpgt_epi8(v, SPLAT('a' - 1)), _mm_cmplt_epi8(v, SPLAT('f' + 1))); \
+	out = _mm_or_si128(_mm_or_si128(_mm_and_si128(d_, _mm_sub_epi8(v, SPLAT('0'))), \
+		_mm_and_si128(u_, _mm_sub_epi8(v, SPLAT('A' - 10)))), \
+		_mm_and_si128(l_, _mm_sub_epi8(v, SPLAT('a' - 10)))); \
+	out = _mm_or_si128(out, _mm_andnot_si128(_mm_or_si128(_mm_or_si128(d_, u_), l_), SPLAT(-1))); \
+}
+
+// Hex digit chars of 16 nibbles (0 - 15):
+#define HEX_CHARS(n) _mm_add_epi8(_mm_add_epi8(n, SPLAT('0')), \
+	_mm_and_si128(_mm_cmpgt_epi8(n, SPLAT(9)), SPLAT('A' - '9' - 1)))
+
+#endif
+
+
+#ifdef USE_CPU_FLAGS
+
+/***********************************************************************
+**
+*/	static TARGET("ssse3") REBYTE *Enbase64_SIMD(REBYTE *p, REBYTE *src, REBCNT blocks, REBFLG url)
+/*
+**		Encode blocks of 12 bytes as 16 chars. Reads 16 bytes each.
+**		(W. Mula and D. Lemire, "Faster Base64 Encoding and
+**		Decoding Using AVX2 Instructions", the SSE version.)
+**
+***********************************************************************/
+{
+	const __m128i split = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+	// Add to each 6 bit index, by range (see below):
+	const __m128i shifts = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		(url ? '-' : '+') - 62, (url ? '_' : '/') - 63, 'A', 0, 0);
+	__m128i in, idx, r;
+
+	for (; blocks > 0; blocks--, src += 12, p += 16) {
+		// Each 3 bytes to a 32 bit lane, then to four 6 bit indexes:
+		in = _mm_shuffle_epi8(LOAD_16(src), split);
+		idx = _mm_or_si128(
+			_mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)),
+			_mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010))
+		);
+		// 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12:
+		r = _mm_subs_epu8(idx, SPLAT(51));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_cmpgt_epi8(SPLAT(26), idx), SPLAT(13)));
+		STORE_16(p, _mm_add_epi8(idx, _mm_shuffle_epi8(shifts, r)));
+	}
+
+	return p;
+}
+
+
+/***********************************************************************
+**
+*/	static TARGET("ssse3") REBCNT Debase64_SIMD(REBYTE *bp, REBYTE *cp, REBCNT blocks, REBFLG url)
+/*
+**		Decode blocks of 16 chars into 12 bytes, stopping at the
+**		first block that has anything but base-64 chars (spaces,
+**		padding, errors), which is left for the caller. Writes 16
+**		bytes each. Returns the number of blocks done.
+**
+***********************************************************************/
+{
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+	__m128i c, up, lo, dig, c62, c63, val;
+	REBCNT n;
+
+	for (n = 0; n < blocks; n++, cp += 16, bp += 12) {
+		c = LOAD_16(cp);
+		up = _mm_and_si128(_mm_cmpgt_epi8(c, SPLAT('A' - 1)), _mm_cmplt_epi8(c, SPLAT('Z' + 1)));
+		lo = _mm_and_si128(_mm_cmpgt_epi8(c, SPLAT('a' - 1)), _mm_cmplt_epi8(c, SPLAT('z' + 1)));
+		dig = _mm_and_si128(_mm_cmpgt_epi8(c, SPLAT('0' - 1)), _mm_cmplt_epi8(c, SPLAT('9' + 1)));
+		c62 = IS_CHR(c, url ? '-' : '+');
+		c63 = IS_CHR(c, url ? '_' : '/');
+		if (HIGH_BITS(_mm_or_si128(_mm_or_si128(_mm_or_si128(up, lo), dig), _mm_or_si128(c62, c63))) != 0xFFFF)
+			break;
+
+		// Char to value (the masks do not overlap):
+		val = _mm_or_si128(_mm_or_si128(
+			_mm_and_si128(up, SPLAT(-'A')),
+			_mm_and_si128(lo, SPLAT(26 - 'a'))), _mm_or_si128(
+			_mm_and_si128(dig, SPLAT(52 - '0')), _mm_or_si128(
+			_mm_and_si128(c62, SPLAT(62 - (url ? '-' : '+'))),
+			_mm_and_si128(c63, SPLAT(63 - (url ? '_' : '/'))))));
+		val = _mm_add_epi8(c, val);
+
+		// Join four 6 bit values per lane, then pack the 3 bytes:
+		val = _mm_maddubs_epi16(val, _mm_set1_epi32(0x01400140));
+		val = _mm_madd_epi16(val, _mm_set1_epi32(0x00011000));
+		STORE_16(bp, _mm_shuffle_epi8(val, pack));
+	}
+
+	return n;
+}
+
+#endif
+
+
 /***********************************************************************
 **
 */	static REBSER *Decode_Base2(REBYTE **src, REBCNT len, REBYTE delim)
@@ -242,6 +359,21 @@ err:
 
 	for (; len > 0; cp++, len--) {
 
+#ifdef USE_SSE2
+		// Runs of hex digits, 16 at a time:
+		if (!(count & 1)) {
+			__m128i v;
+			for (; len >= 16; cp += 16, len -= 16, bp += 8) {
+				HEX_VALUES(LOAD_16(cp), v);
+				if (HIGH_BITS(v)) break; // not all hex digits
+				// First digit of each pair is the high nibble:
+				v = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0xFF)), 4), _mm_srli_epi16(v, 8));
+				_mm_storel_epi64((__m128i *)bp, _mm_packus_epi16(v, v));
+			}
+			if (!len) break;
+		}
+#endif
+
 		if (delim && *cp == delim) break;
 
 		lex = Lex_Map[*cp];
@@ -269,8 +401,11 @@ err:
 								
 /***********************************************************************
 **
-*/	static REBSER *Decode_Base64(REBYTE **src, REBCNT len, REBYTE delim)
+*/	static REBSER *Decode_Base64(REBYTE **src, REBCNT len, REBYTE delim, REBFLG url)
 /*
+**		The URL safe alphabet (url) uses - and _ for + and /, and
+**		its padding is optional.
+**
 ***********************************************************************/
 {
 	REBYTE *bp;
@@ -279,6 +414,10 @@ err:
 	REBINT accum = 0;
 	REBYTE lex;
 	REBSER *ser;
+#ifdef USE_CPU_FLAGS
+	REBFLG simd = CPU_Flags() & CPU_SSSE3;
+	REBCNT n;
+#endif
 
 	// Allocate buffer large enough to hold result:
 	// Accounts for e bytes decoding into 3 bytes.
@@ -288,6 +427,17 @@ err:
 
 	for (; len > 0; cp++, len--) {
 
+#ifdef USE_CPU_FLAGS
+		// Whole quads, 16 chars at a time. (Stops 8 chars early
+		// so that its 16 byte stores stay inside the buffer.)
+		if (!flip && simd && len >= 24) {
+			n = Debase64_SIMD(bp, cp, (len - 8) / 16, url);
+			bp += n * 12;
+			cp += n * 16;
+			len -= n * 16;
+		}
+#endif
+
 		// Check for terminating delimiter (optional):
 		if (delim && *cp == delim) break;
 
@@ -298,6 +448,11 @@ err:
 		}
 
 		lex = Debase64[*cp];
+		if (url) {
+			if (*cp == '-') lex = 62;
+			else if (*cp == '_') lex = 63;
+			else if (*cp == '+' || *cp == '/') lex = BIN_ERROR;
+		}
 
 		if (lex < BIN_SPACE) {
 
@@ -332,7 +487,13 @@ err:
 		else if (lex == BIN_ERROR) goto err;
 	}
 
-	if (flip) goto err;
+	// Without padding, the last quad may be short:
+	if (url && flip == 3) {
+		*bp++ = (REBYTE)(accum >> 10);
+		*bp++ = (REBYTE)(accum >> 2);
+	}
+	else if (url && flip == 2) *bp++ = (REBYTE)(accum >> 4);
+	else if (flip) goto err;
 
 	*bp = 0;
 	ser->tail = bp - STR_HEAD(ser);
@@ -347,9 +508,10 @@ err:
 
 /***********************************************************************
 **
-*/	REBYTE *Decode_Binary(REBVAL *value, REBYTE *src, REBCNT len, REBINT base, REBYTE delim)
+*/	REBYTE *Decode_Binary(REBVAL *value, REBYTE *src, REBCNT len, REBINT base, REBYTE delim, REBFLG url)
 /*
-**		Scan and convert a binary string.
+**		Scan and convert a binary string. The url flag selects
+**		the URL safe base-64 alphabet.
 **
 ***********************************************************************/
 {
@@ -357,7 +519,7 @@ err:
 
 	switch (base) {
 	case 64:
-		ser = Decode_Base64(&src, len, delim);
+		ser = Decode_Base64(&src, len, delim, url);
 		break;
 	case 16:
 		ser = Decode_Base16(&src, len, delim);
@@ -425,25 +587,39 @@ err:
 **
 ***********************************************************************/
 {
-	REBCNT count;
 	REBCNT len;
+	REBCNT n;
 	REBYTE *bp;
 	REBYTE *src;
 
 	len = VAL_LEN(value);
 	src = VAL_BIN_DATA(value);
 
-	// Account for hex, lines, and extra syntax:
-	series = Prep_String(series, &bp, len*2 + len/32 + 32);
+	// Hex, then line breaks (every 32 bytes, and first and last):
+	series = Prep_String(series, &bp, len*2 + (brk ? len/32 + 2 : 0));
 	// (Note: tail not properly set yet)
 
 	if (len >= 32 && brk) *bp++ = LF;
-	for (count = 1; count <= len; count++) {
-		bp = Form_Hex2(bp, *src++);
-		if (brk && ((count % 32) == 0)) *bp++ = LF;
+	while (len > 0) {
+		n = (brk && len > 32) ? 32 : len;
+		len -= n;
+#ifdef USE_SSE2
+		for (; n >= 16; n -= 16, src += 16, bp += 32) {
+			__m128i v = LOAD_16(src);
+			__m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), SPLAT(0x0F));
+			__m128i lo = _mm_and_si128(v, SPLAT(0x0F));
+			STORE_16(bp, HEX_CHARS(_mm_unpacklo_epi8(hi, lo)));
+			STORE_16(bp + 16, HEX_CHARS(_mm_unpackhi_epi8(hi, lo)));
+		}
+#endif
+		for (; n > 0; n--, src++) {
+			*bp++ = Hex_Digits[*src >> 4];
+			*bp++ = Hex_Digits[*src & 0xf];
+		}
+		if (brk && len > 0) *bp++ = LF;
 	}
 
-	if (*(bp-1) != LF && (len >= 32) && brk) *bp++ = LF;
+	if (VAL_LEN(value) >= 32 && brk) *bp++ = LF;
 	*bp = 0;
 	
 	SERIES_TAIL(series) = DIFF_PTRS(bp, series->data);
@@ -454,50 +630,73 @@ err:
 
 /***********************************************************************
 **
-*/  REBSER *Encode_Base64(REBVAL *value, REBSER *series, REBFLG brk)
+*/  REBSER *Encode_Base64(REBVAL *value, REBSER *series, REBFLG brk, REBFLG url)
 /*
 **		Base64 encode a given series. Must be BYTES, not UNICODE.
+**		The url flag selects the URL safe alphabet, without padding.
 **
 ***********************************************************************/
 {
 	REBYTE *p;
 	REBYTE *src;
+	REBYTE *end;
+	const REBYTE *table = url ? Enbase64_URL : Enbase64;
 	REBCNT len;
-	REBINT x, loop;
+	REBCNT groups;
+	REBCNT x, n;
+#ifdef USE_CPU_FLAGS
+	REBFLG simd = CPU_Flags() & CPU_SSSE3;
+	REBCNT blocks;
+#endif
 
 	len = VAL_LEN(value);
-	src = VAL_BIN(value);
-	
-	// slop-factor
-  	series = Prep_String (series, &p, 4 * len / 3 + 2 * (len / 32) + 5);
-	loop = (int) (len / 3) - 1;
-	if (4 * loop > 64 && brk) *p++ = LF;
-
- 	for (x = 0; x <= 3 * loop; x += 3) {
-		*p++ = Enbase64[src[x] >> 2];
-		*p++ = Enbase64[((src[x] & 0x3) << 4) + (src[x + 1] >> 4)];
-		*p++ = Enbase64[((src[x + 1] & 0xF) << 2) + (src[x + 2] >> 6)];
-		*p++ = Enbase64[(src[x + 2] % 0x40)];
-		if ((x+3) % 48 == 0 && brk)
-			*p++ = LF;
+	src = VAL_BIN_DATA(value);
+	groups = len / 3; // of 3 bytes
+
+	// Exact size: chars, then line breaks (every 16 groups, first and last):
+	series = Prep_String(series, &p, (url ? (len * 4 + 2) / 3 : (len + 2) / 3 * 4) + (brk ? groups / 16 + 2 : 0));
+	if (groups > 17 && brk) *p++ = LF;
+
+	for (x = 0; x < groups; x += n) {
+		n = (brk && groups - x > 16) ? 16 : groups - x;
+		src = VAL_BIN_DATA(value) + 3 * x;
+		end = src + 3 * n;
+#ifdef USE_CPU_FLAGS
+		// Four groups per block, while 16 bytes can be read:
+		if (simd && len - 3 * x >= 16) {
+			blocks = MIN(n / 4, (len - 3 * x - 4) / 12);
+			p = Enbase64_SIMD(p, src, blocks, url);
+			src += 12 * blocks;
+		}
+#endif
+		for (; src < end; src += 3) {
+			*p++ = table[src[0] >> 2];
+			*p++ = table[((src[0] & 0x3) << 4) + (src[1] >> 4)];
+			*p++ = table[((src[1] & 0xF) << 2) + (src[2] >> 6)];
+			*p++ = table[src[2] & 0x3F];
+		}
+		if (brk && (x + n) % 16 == 0) *p++ = LF;
 	}
 
-	if ((len % 3) != 0) {
-		p[2] = p[3] = '=';
-		*p++ = Enbase64[src[x] >> 2];
-		if ((len - x) >= 1)
-			*p++ = Enbase64[((src[x] & 0x3) << 4) + ((len - x) == 1 ? 0 : src[x + 1] >> 4)];
-		else p++;
-		if ((len - x) == 2)
-			*p++ = Enbase64[(src[x + 1] & 0xF) << 2];
-		else p++;
-		p++;
+	// Last 1 or 2 bytes:
+	src = VAL_BIN_DATA(value) + 3 * groups;
+	if (len > 3 * groups) {
+		*p++ = table[src[0] >> 2];
+		if (len - 3 * groups == 1) {
+			*p++ = table[(src[0] & 0x3) << 4];
+			if (!url) *p++ = '=';
+		}
+		else {
+			*p++ = table[((src[0] & 0x3) << 4) + (src[1] >> 4)];
+			*p++ = table[(src[1] & 0xF) << 2];
+		}
+		if (!url) *p++ = '=';
 	}
 
-	if (*(p-1) != LF && x > 49 && brk) *p++ = LF;
+	if (3 * groups > 49 && brk && p[-1] != LF) *p++ = LF;
 	*p = 0;
 
-	SERIES_TAIL(series) = DIFF_PTRS(p, series->data); /* 4 * (int) (len % 3 ? (len / 3) + 1 : len / 3); */
+	SERIES_TAIL(series) = DIFF_PTRS(p, series->data);
 
 	return series;
 }
@@ -34,6 +34,14 @@
 #include "sys-core.h"
 #include "sys-dec-to-char.h"
 
+// Two digit strings "00" to "99", for forming two digits at a time:
+static const REBYTE Digit_Pairs[] =
+	"00010203040506070809" "10111213141516171819"
+	"20212223242526272829" "30313233343536373839"
+	"40414243444546474849" "50515253545556575859"
+	"60616263646566676869" "70717273747576777879"
+	"80818283848586878889" "90919293949596979899";
+
 
 /***********************************************************************
 **
@@ -220,8 +228,7 @@
 **
 ***********************************************************************/
 {
-	INT_TO_STR(val, buf);
-	return buf+LEN_BYTES(buf);
+	return buf + Emit_Integer(buf, val);
 }
 
 
@@ -229,10 +236,33 @@
 **
 */	REBINT Emit_Integer(REBYTE *buf, REBI64 val)
 /*
+**		Form an integer in the buffer (MAX_INT_LEN + 1 bytes) and
+**		return its length. Digits are formed two at a time, from
+**		the end, so no reversal or length scan is needed.
+**
 ***********************************************************************/
 {
-	INT_TO_STR(val, buf);
-	return LEN_BYTES(buf);
+	REBYTE tmp[MAX_INT_LEN + 1];
+	REBYTE *tp = tmp + MAX_INT_LEN;
+	REBU64 n = (val < 0) ? (REBU64)0 - (REBU64)val : (REBU64)val;
+	REBCNT r;
+	REBINT len;
+
+	while (n >= 100) {
+		r = (REBCNT)(n % 100) * 2;
+		n /= 100;
+		*--tp = Digit_Pairs[r + 1];
+		*--tp = Digit_Pairs[r];
+	}
+	r = (REBCNT)n * 2;
+	*--tp = Digit_Pairs[r + 1];
+	if (n >= 10) *--tp = Digit_Pairs[r];
+	if (val < 0) *--tp = '-';
+
+	len = (REBINT)(tmp + MAX_INT_LEN - tp);
+	memcpy(buf, tp, len);
+	buf[len] = 0;
+	return len;
 }
 
 
@@ -390,8 +420,51 @@ static int Convert_Decimal(REBDEC d, REBI64 *sig, REBINT *point)
 /* this is appropriate for 64-bit IEEE754 binary floating point format */
 #define MAX_DIGITS 17
 
+/* powers of ten that are exact doubles, and limit of short decimals (2^50) */
+static const REBDEC Exact_Pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+	1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+};
+#define MAX_SHORT_DEC 1125899906842624.0
+
+/***********************************************************************
+**
+*/	static REBINT Short_Decimal(REBDEC d, REBYTE *digits, int *e)
+/*
+**		Fast path for positive decimals with up to 15 digits after
+**		the point that fit in 2^50 when scaled (prices, measures,
+**		and the like). Finds the smallest k for which n / 10^k
+**		converts back to d. As n and 10^k are exact doubles, that
+**		division is correctly rounded, as is the scan of the digits,
+**		so the digits load back as d. They are the shortest such
+**		digits, so the same as dtoa (mode 0) gives.
+**
+**		Returns the number of digits, or zero if d needs dtoa.
+**
+***********************************************************************/
+{
+	REBDEC x;
+	REBI64 n = 0;
+	REBINT k;
+	REBINT len;
+
+	for (k = 0; k < 16; k++) {
+		x = d * Exact_Pow10[k];
+		if (!(x < MAX_SHORT_DEC)) return 0; // (also NaN)
+		n = (REBI64)(x + 0.5);
+		if (n && (REBDEC)n / Exact_Pow10[k] == d) break;
+	}
+	if (k == 16) return 0;
+
+	len = Emit_Integer(digits, n);
+	*e = len - k;
+	while (digits[len - 1] == '0') len--; // (only when k is zero)
+	return len;
+}
+
 REBINT Emit_Decimal(REBYTE *cp, REBDEC d, REBFLG trim, REBYTE point, REBINT decimal_digits) {
 	REBYTE *start = cp, *sig, *rve;
+	REBYTE digits[MAX_INT_LEN + 1];
 	int e, sgn;
 	REBINT digits_obtained;
 
@@ -399,9 +472,15 @@ REBINT Emit_Decimal(REBYTE *cp, REBDEC d, REBFLG trim, REBYTE point, REBINT deci
 	if (decimal_digits < MIN_DIGITS) decimal_digits = MIN_DIGITS;
 	else if (decimal_digits > MAX_DIGITS) decimal_digits = MAX_DIGITS;
 
-	sig = (REBYTE *) dtoa (d, 0, decimal_digits, &e, &sgn, (char **) &rve);
-
-	digits_obtained = rve - sig;
+	/* short decimals, and most others, do not need dtoa */
+	sgn = (d < 0);
+	digits_obtained = Short_Decimal(sgn ? -d : d, digits, &e);
+	if (!digits_obtained) digits_obtained = Fast_Dtoa(sgn ? -d : d, digits, &e);
+	if (digits_obtained) sig = digits;
+	else {
+		sig = (REBYTE *) dtoa (d, 0, decimal_digits, &e, &sgn, (char **) &rve);
+		digits_obtained = rve - sig;
+	}
 
 	/* handle sign */
 	if (sgn) *cp++ = '-';
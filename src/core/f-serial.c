@@ -0,0 +1,667 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  f-serial.c
+**  Summary: binary serialized values (save/binary)
+**  Section: functional
+**  Notes:
+**		The format is a header, series records, then symbols:
+**
+**		header:  SERIAL_HEAD, which holds the saved value itself.
+**		records: a SERIAL_REC, then the series data with its
+**		         terminator, padded to 8 bytes. The data of blocks
+**		         is an image of their value cells.
+**		symbols: the zero terminated UTF-8 names of the words.
+**
+**		Within the cells, series pointers are replaced with the
+**		offset of their record, and word symbols with an index into
+**		the symbols. Words are saved unbound. A series is saved once
+**		no matter how many values refer to it, so shared series and
+**		cycles load back the same way.
+**
+**		Values are saved as they are in memory, so the data can be
+**		loaded only by builds with the same byte order and value
+**		size. The header records both.
+**
+***********************************************************************/
+
+#include "sys-core.h"
+
+#define SERIAL_MAGIC	"\0REBSER"	// followed by version byte
+#define SERIAL_VERSION	1
+#define SERIAL_CHECK	0x01020304	// byte order check
+#define SERIAL_ALIGN(n)	ALIGN(n, 8)
+
+typedef struct rebol_serial_head {
+	REBYTE magic[8];	// SERIAL_MAGIC and SERIAL_VERSION
+	REBCNT check;		// SERIAL_CHECK in the byte order of the data
+	REBCNT cell;		// sizeof(REBVAL)
+	REBCNT symbols;		// offset of the symbol names
+	REBCNT count;		// number of symbols
+	REBVAL value;		// the saved value
+} SERIAL_HEAD;
+
+typedef struct rebol_serial_rec {
+	REBCNT kind;		// SERIAL_BYTES, etc.
+	REBCNT wide;		// unit width
+	REBCNT tail;		// units, not counting terminator
+	REBCNT size;		// size field of vectors, bitsets, and images
+} SERIAL_REC;
+
+enum {
+	SERIAL_BYTES = 1,	// binary, strings, bitsets, images, vectors
+	SERIAL_BLOCK,		// blocks, parens, paths
+	SERIAL_MAP,			// key and value block of a map
+	SERIAL_FRAME,		// object frame (values)
+	SERIAL_WORDS,		// object frame words
+};
+
+typedef struct rebol_serial_entry {
+	REBUPT key;			// series pointer or record offset
+	REBUPT val;			// the other one
+} SERIAL_ENTRY;
+
+typedef struct rebol_serial_todo {
+	REBSER *series;		// block to decode
+	REBCNT kind;		// its record kind
+	REBCNT tail;		// its tail once decoded
+	REBVAL first;		// its first cell (an END is left in its place)
+} SERIAL_TODO;
+
+typedef struct rebol_serial {
+	REBSER *out;		// encoded binary
+	REBYTE *data;		// decoded data
+	REBCNT len;			// end of decoded records (start of symbols)
+	REBFLG mapped;		// decode the data in place (a mapped file)
+	REBSER *table;		// SERIAL_ENTRY hash of series and records
+	REBCNT count;		// entries used in table
+	REBSER *syms;		// symbol map (global to local, or back)
+	REBSER *names;		// local symbols, in order (encode)
+	REBSER *todo;		// SERIAL_TODO blocks to be decoded (decode)
+} SERIAL;
+
+#define SERIAL_SYMS(s)	((REBCNT *)SERIES_DATA((s)->syms))
+#define SERIAL_TODOS(s)	((SERIAL_TODO *)SERIES_DATA((s)->todo))
+
+
+/***********************************************************************
+**
+*/	static SERIAL_ENTRY *Serial_Entry(SERIAL *ser, REBUPT key)
+/*
+**		Find the entry for the key in the hash table, or the empty
+**		entry where it belongs.
+**
+***********************************************************************/
+{
+	SERIAL_ENTRY *entries = (SERIAL_ENTRY *)SERIES_DATA(ser->table);
+	REBCNT mask = SERIES_TAIL(ser->table) - 1;
+	REBCNT n = (REBCNT)(key >> 3) * 2654435761U;
+
+	for (n &= mask; entries[n].key && entries[n].key != key; n = (n + 1) & mask);
+
+	return entries + n;
+}
+
+
+/***********************************************************************
+**
+*/	static void Serial_Add(SERIAL *ser, REBUPT key, REBUPT val)
+/*
+**		Add a new key to the hash table. Doubles the table when it
+**		gets half full.
+**
+***********************************************************************/
+{
+	SERIAL_ENTRY *entry;
+	REBSER *old = ser->table;
+	REBCNT size = old ? SERIES_TAIL(old) : 0;
+	REBCNT n;
+
+	if (!old || ser->count * 2 >= size) {
+		size = size ? size * 2 : 256;
+		ser->table = Make_Series(size + 1, sizeof(SERIAL_ENTRY), FALSE);
+		CLEAR(SERIES_DATA(ser->table), size * sizeof(SERIAL_ENTRY));
+		ser->table->tail = size;
+		if (old) {
+			entry = (SERIAL_ENTRY *)SERIES_DATA(old);
+			for (n = 0; n < SERIES_TAIL(old); n++, entry++)
+				if (entry->key) *Serial_Entry(ser, entry->key) = *entry;
+		}
+	}
+
+	entry = Serial_Entry(ser, key);
+	entry->key = key;
+	entry->val = val;
+	ser->count++;
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Serial_Append(SERIAL *ser, void *data, REBCNT len)
+/*
+**		Append data to the output, padded with zeros to 8 bytes.
+**		If data is zero, append all zeros. Returns its offset.
+**
+***********************************************************************/
+{
+	REBSER *out = ser->out;
+	REBCNT pos = SERIES_TAIL(out);
+	REBCNT size = SERIAL_ALIGN(len);
+
+	EXPAND_SERIES_TAIL(out, size);
+	CLEAR(BIN_SKIP(out, pos), size);
+	if (data) memcpy(BIN_SKIP(out, pos), data, len);
+
+	return pos;
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Serial_Series(SERIAL *ser, REBSER *series, REBCNT kind)
+/*
+**		Return the record offset of a series, adding its record
+**		if it has not been saved yet. Block cells are converted
+**		later (see Serialize_Value).
+**
+***********************************************************************/
+{
+	SERIAL_ENTRY *entry;
+	SERIAL_REC rec;
+	REBCNT pos;
+
+	if (ser->table) {
+		entry = Serial_Entry(ser, (REBUPT)series);
+		if (entry->key) return (REBCNT)entry->val;
+	}
+
+	rec.kind = kind;
+	rec.wide = SERIES_WIDE(series);
+	rec.tail = SERIES_TAIL(series);
+	rec.size = (kind == SERIAL_BYTES) ? series->size : 0;
+
+	pos = Serial_Append(ser, &rec, sizeof(rec));
+	Serial_Append(ser, 0, (rec.tail + 1) * rec.wide); // zero terminated
+	memcpy(BIN_SKIP(ser->out, pos + sizeof(rec)), SERIES_DATA(series), rec.tail * rec.wide);
+
+	Serial_Add(ser, (REBUPT)series, pos);
+
+	return pos;
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Serial_Sym(SERIAL *ser, REBCNT sym)
+/*
+**		Return the local index of a word symbol, plus one. Zero
+**		stays zero (the SELF of a selfless frame).
+**
+***********************************************************************/
+{
+	REBCNT *map = SERIAL_SYMS(ser);
+
+	if (sym && !map[sym]) {
+		EXPAND_SERIES_TAIL(ser->names, 1);
+		((REBCNT *)SERIES_DATA(ser->names))[SERIES_TAIL(ser->names) - 1] = sym;
+		map[sym] = SERIES_TAIL(ser->names);
+	}
+
+	return map[sym];
+}
+
+
+/***********************************************************************
+**
+*/	static void Serial_Cell(SERIAL *ser, REBCNT pos, REBCNT kind)
+/*
+**		Convert the value cell at pos in the output: replace its
+**		series and frames with record offsets, and its word symbol
+**		with its local index. The kind is that of the containing
+**		record (or zero for the saved value).
+**
+***********************************************************************/
+{
+	REBVAL *val = (REBVAL *)BIN_SKIP(ser->out, pos);
+	REBCNT n = 0;
+
+	switch (VAL_TYPE(val)) {
+
+	case REB_UNSET:
+	case REB_NONE:
+	case REB_LOGIC:
+	case REB_INTEGER:
+	case REB_DECIMAL:
+	case REB_PERCENT:
+	case REB_MONEY:
+	case REB_CHAR:
+	case REB_PAIR:
+	case REB_TUPLE:
+	case REB_TIME:
+	case REB_DATE:
+	case REB_TYPESET:
+		return;
+
+	case REB_DATATYPE:
+		VAL_TYPE_SPEC(val) = 0;
+		return;
+
+	case REB_BINARY:
+	case REB_STRING:
+	case REB_FILE:
+	case REB_EMAIL:
+	case REB_URL:
+	case REB_TAG:
+	case REB_BITSET:
+	case REB_IMAGE:
+	case REB_VECTOR:
+		n = Serial_Series(ser, VAL_SERIES(val), SERIAL_BYTES);
+		break;
+
+	case REB_BLOCK:
+	case REB_PAREN:
+	case REB_PATH:
+	case REB_SET_PATH:
+	case REB_GET_PATH:
+	case REB_LIT_PATH:
+		n = Serial_Series(ser, VAL_SERIES(val), SERIAL_BLOCK);
+		break;
+
+	case REB_MAP:
+		n = Serial_Series(ser, VAL_SERIES(val), SERIAL_MAP);
+		break;
+
+	case REB_OBJECT:
+		n = Serial_Series(ser, VAL_OBJ_FRAME(val), SERIAL_FRAME);
+		val = (REBVAL *)BIN_SKIP(ser->out, pos);
+		VAL_OBJ_FRAME(val) = (REBSER *)(REBUPT)n;
+		VAL_MOD_BODY(val) = 0;
+		return;
+
+	case REB_FRAME:
+		if (kind != SERIAL_FRAME) Trap1(RE_INVALID_TYPE, Of_Type(val));
+		n = Serial_Series(ser, VAL_FRM_WORDS(val), SERIAL_WORDS);
+		val = (REBVAL *)BIN_SKIP(ser->out, pos);
+		VAL_FRM_WORDS(val) = (REBSER *)(REBUPT)n;
+		VAL_FRM_SPEC(val) = 0;
+		return;
+
+	case REB_WORD:
+	case REB_SET_WORD:
+	case REB_GET_WORD:
+	case REB_LIT_WORD:
+	case REB_REFINEMENT:
+	case REB_ISSUE:
+		VAL_WORD_SYM(val) = Serial_Sym(ser, VAL_WORD_SYM(val));
+		if (!VAL_GET_OPT(val, OPTS_UNWORD)) UNBIND(val); // (frame words hold a typeset)
+		return;
+
+	default:
+		Trap1(RE_INVALID_TYPE, Of_Type(val));
+	}
+
+	val = (REBVAL *)BIN_SKIP(ser->out, pos); // (output may have moved)
+	VAL_SERIES(val) = (REBSER *)(REBUPT)n;
+	VAL_SERIES_SIDE(val) = 0;
+}
+
+
+/***********************************************************************
+**
+*/	REBSER *Serialize_Value(REBVAL *value)
+/*
+**		Encode a value, and all the series it refers to, as a
+**		binary (see the notes above).
+**
+***********************************************************************/
+{
+	SERIAL ser;
+	SERIAL_HEAD *head;
+	SERIAL_REC *rec;
+	REBYTE *name;
+	REBCNT pos;
+	REBCNT len;
+	REBCNT n;
+
+	CLEARS(&ser);
+	ser.out = Make_Binary(4000);
+	ser.syms = Make_Series(PG_Word_Table.series->tail + 1, sizeof(REBCNT), FALSE);
+	CLEAR(SERIES_DATA(ser.syms), (PG_Word_Table.series->tail + 1) * sizeof(REBCNT));
+	ser.names = Make_Series(100, sizeof(REBCNT), FALSE);
+
+	Serial_Append(&ser, 0, sizeof(SERIAL_HEAD));
+	head = (SERIAL_HEAD *)BIN_HEAD(ser.out);
+	memcpy(head->magic, SERIAL_MAGIC, 7);
+	head->magic[7] = SERIAL_VERSION;
+	head->check = SERIAL_CHECK;
+	head->cell = sizeof(REBVAL);
+	head->value = *value;
+	Serial_Cell(&ser, (REBCNT)((REBYTE *)&head->value - (REBYTE *)head), 0);
+
+	// Convert the cells of each block record. Any new records
+	// they need go to the tail, so get their turn in this loop:
+	for (pos = SERIAL_ALIGN(sizeof(SERIAL_HEAD)); pos < SERIES_TAIL(ser.out); pos += len) {
+		rec = (SERIAL_REC *)BIN_SKIP(ser.out, pos);
+		len = sizeof(SERIAL_REC) + SERIAL_ALIGN((rec->tail + 1) * rec->wide);
+		if (rec->kind == SERIAL_BYTES) continue;
+		for (n = 0; n < rec->tail; n++) {
+			rec = (SERIAL_REC *)BIN_SKIP(ser.out, pos);
+			Serial_Cell(&ser, pos + sizeof(SERIAL_REC) + n * rec->wide, rec->kind);
+		}
+	}
+
+	head = (SERIAL_HEAD *)BIN_HEAD(ser.out);
+	head->symbols = SERIES_TAIL(ser.out);
+	head->count = SERIES_TAIL(ser.names);
+
+	for (n = 0; n < SERIES_TAIL(ser.names); n++) {
+		name = Get_Sym_Name(((REBCNT *)SERIES_DATA(ser.names))[n]);
+		Append_Mem_Extra(ser.out, name, LEN_BYTES(name), 1);
+		ser.out->tail++; // keep the terminator
+	}
+	TERM_SERIES(ser.out);
+
+	return ser.out;
+}
+
+
+/***********************************************************************
+**
+*/	static void Deserial_Rec(SERIAL *ser, REBCNT pos, REBCNT kind, SERIAL_REC *rec)
+/*
+**		Get and check the header of the record at pos.
+**
+***********************************************************************/
+{
+	if (
+		pos < SERIAL_ALIGN(sizeof(SERIAL_HEAD))
+		|| pos != SERIAL_ALIGN(pos)
+		|| pos > ser->len - sizeof(*rec)
+	) Trap0(RE_BAD_SERIAL);
+	memcpy(rec, ser->data + pos, sizeof(*rec));
+
+	if (
+		rec->kind != kind
+		|| (kind == SERIAL_BYTES ?
+			(rec->wide != 1 && rec->wide != 2 && rec->wide != 4 && rec->wide != 8)
+			: rec->wide != sizeof(REBVAL))
+		|| ((REBU64)rec->tail + 1) * rec->wide > ser->len - pos - sizeof(*rec)
+		|| (kind == SERIAL_MAP && (rec->tail & 1))
+	) Trap0(RE_BAD_SERIAL);
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Deserial_Series(SERIAL *ser, REBCNT pos, REBCNT kind)
+/*
+**		Return the series for the record at pos, making it if it
+**		was not made yet. Blocks are queued to decode their cells,
+**		and are empty until then.
+**
+***********************************************************************/
+{
+	SERIAL_ENTRY *entry;
+	SERIAL_TODO *todo;
+	SERIAL_REC rec;
+	REBSER *series = 0;
+	REBYTE *bp;
+
+	Deserial_Rec(ser, pos, kind, &rec);
+
+	if (ser->table) {
+		entry = Serial_Entry(ser, pos);
+		if (entry->key) return (REBSER *)entry->val;
+	}
+
+	// Use the data where it is, or copy it:
+	bp = ser->data + pos + sizeof(rec);
+	if (ser->mapped) series = Make_Mapped_Series(bp, rec.tail, rec.wide);
+	if (!series) {
+		series = Make_Series(rec.tail + 1, rec.wide, FALSE);
+		memcpy(SERIES_DATA(series), bp, rec.tail * rec.wide);
+	}
+	series->tail = rec.tail;
+	TERM_SERIES(series);
+
+	if (kind == SERIAL_BYTES) series->size = rec.size;
+	else {
+		// Cells are not valid until decoded, so hide them:
+		EXPAND_SERIES_TAIL(ser->todo, 1);
+		todo = SERIAL_TODOS(ser) + SERIES_TAIL(ser->todo) - 1;
+		todo->series = series;
+		todo->kind = kind;
+		todo->tail = rec.tail;
+		todo->first = *BLK_HEAD(series);
+		SET_END(BLK_HEAD(series));
+		series->tail = 0;
+		if (kind == SERIAL_WORDS) BARE_SERIES(series);
+	}
+
+	Serial_Add(ser, pos, (REBUPT)series);
+
+	return series;
+}
+
+
+/***********************************************************************
+**
+*/	static void Deserial_Cell(SERIAL *ser, REBVAL *val, SERIAL_TODO *todo, REBCNT index)
+/*
+**		Decode a value cell at index of a queued block (or the
+**		saved value if todo is zero). Reverse of Serial_Cell.
+**		Checks each cell, its sizes and its series index against
+**		the records, so corrupt data cannot make bad values.
+**
+***********************************************************************/
+{
+	REBSER *series;
+	SERIAL_REC rec;
+	REBCNT kind = todo ? todo->kind : 0;
+	REBCNT wide;
+
+	switch (VAL_TYPE(val)) {
+
+	case REB_UNSET:
+	case REB_NONE:
+	case REB_LOGIC:
+	case REB_INTEGER:
+	case REB_DECIMAL:
+	case REB_PERCENT:
+	case REB_MONEY:
+	case REB_CHAR:
+	case REB_PAIR:
+	case REB_TUPLE:
+	case REB_TIME:
+	case REB_DATE:
+	case REB_TYPESET:
+		return;
+
+	case REB_DATATYPE:
+		if ((REBCNT)VAL_DATATYPE(val) >= REB_MAX) break;
+		VAL_TYPE_SPEC(val) = 0;
+		return;
+
+	case REB_BINARY:
+	case REB_STRING:
+	case REB_FILE:
+	case REB_EMAIL:
+	case REB_URL:
+	case REB_TAG:
+	case REB_BITSET:
+	case REB_IMAGE:
+	case REB_VECTOR:
+		series = Deserial_Series(ser, (REBCNT)(REBUPT)VAL_SERIES(val), SERIAL_BYTES);
+		wide = SERIES_WIDE(series);
+		if (IS_BINARY(val) || IS_BITSET(val)) {
+			if (wide != 1) break;
+		}
+		else if (IS_IMAGE(val)) {
+			// The pixels must be all of the record:
+			if (wide != 4 || IMG_WIDE(series) * IMG_HIGH(series) != SERIES_TAIL(series)) break;
+		}
+		else if (IS_VECTOR(val)) {
+			if (wide != (REBCNT)(1 << (series->size & 3))) break;
+		}
+		else if (wide > 2) break;
+		if (VAL_INDEX(val) > SERIES_TAIL(series)) break;
+		VAL_SERIES(val) = series;
+		VAL_SERIES_SIDE(val) = 0;
+		return;
+
+	case REB_BLOCK:
+	case REB_PAREN:
+	case REB_PATH:
+	case REB_SET_PATH:
+	case REB_GET_PATH:
+	case REB_LIT_PATH:
+		// Blocks stay empty until decoded, so check the record tail:
+		Deserial_Rec(ser, (REBCNT)(REBUPT)VAL_SERIES(val), SERIAL_BLOCK, &rec);
+		if (VAL_INDEX(val) > rec.tail) break;
+		VAL_SERIES(val) = Deserial_Series(ser, (REBCNT)(REBUPT)VAL_SERIES(val), SERIAL_BLOCK);
+		VAL_SERIES_SIDE(val) = 0;
+		return;
+
+	case REB_MAP:
+		Deserial_Rec(ser, (REBCNT)(REBUPT)VAL_SERIES(val), SERIAL_MAP, &rec);
+		if (VAL_INDEX(val) > rec.tail) break;
+		VAL_SERIES(val) = Deserial_Series(ser, (REBCNT)(REBUPT)VAL_SERIES(val), SERIAL_MAP);
+		VAL_SERIES_SIDE(val) = 0;
+		return;
+
+	case REB_OBJECT:
+		VAL_OBJ_FRAME(val) = Deserial_Series(ser, (REBCNT)(REBUPT)VAL_OBJ_FRAME(val), SERIAL_FRAME);
+		VAL_MOD_BODY(val) = 0;
+		return;
+
+	case REB_FRAME:
+		// Only as the head of an object frame, with as many words:
+		if (kind != SERIAL_FRAME || index) break;
+		Deserial_Rec(ser, (REBCNT)(REBUPT)VAL_FRM_WORDS(val), SERIAL_WORDS, &rec);
+		if (rec.tail != todo->tail) break;
+		VAL_FRM_WORDS(val) = Deserial_Series(ser, (REBCNT)(REBUPT)VAL_FRM_WORDS(val), SERIAL_WORDS);
+		VAL_FRM_SPEC(val) = 0;
+		return;
+
+	case REB_WORD:
+	case REB_SET_WORD:
+	case REB_GET_WORD:
+	case REB_LIT_WORD:
+	case REB_REFINEMENT:
+	case REB_ISSUE:
+		if (VAL_WORD_SYM(val) > SERIES_TAIL(ser->syms)) break;
+		VAL_WORD_SYM(val) = SERIAL_SYMS(ser)[VAL_WORD_SYM(val)];
+		if (kind == SERIAL_WORDS) {
+			if (!IS_WORD(val) || !VAL_GET_OPT(val, OPTS_UNWORD)) break;
+			if (!VAL_WORD_SYM(val) && index) break;
+		}
+		else {
+			if (!VAL_WORD_SYM(val)) break;
+			VAL_CLR_OPT(val, OPTS_UNWORD);
+			UNBIND(val);
+		}
+		return;
+	}
+
+	Trap0(RE_BAD_SERIAL);
+}
+
+
+/***********************************************************************
+**
+*/	void Deserialize_Value(REBYTE *data, REBCNT len, REBVAL *out, REBFLG mapped)
+/*
+**		Decode a value encoded by Serialize_Value. Data need not
+**		be aligned. Throws an error if the data is not valid.
+**
+**		If mapped, the data is a mapped file that has been taken
+**		over by the caller (see Take_Mapped_Series). Its series are
+**		then made on the data where it is, and blocks are decoded
+**		in place, so only the pages of blocks are ever copied.
+**
+**		Blocks grow as their cells are decoded, so if an error
+**		is thrown part way, no bad cells are left for the GC.
+**
+***********************************************************************/
+{
+	SERIAL ser;
+	SERIAL_HEAD head;
+	SERIAL_TODO todo;
+	REBVAL *cell;
+	REBVAL val;
+	REBYTE *cp;
+	REBYTE *ep;
+	REBCNT n;
+	REBCNT i;
+
+	if (len < sizeof(head)) Trap0(RE_BAD_SERIAL);
+	memcpy(&head, data, sizeof(head));
+	if (
+		memcmp(head.magic, SERIAL_MAGIC, 7) || head.magic[7] != SERIAL_VERSION
+		|| head.check != SERIAL_CHECK || head.cell != sizeof(REBVAL)
+		|| head.symbols < sizeof(head) || head.symbols > len
+	) Trap0(RE_BAD_SERIAL);
+
+	CLEARS(&ser);
+	ser.data = data;
+	ser.len = head.symbols;
+	ser.mapped = mapped && !((REBUPT)data & 7);
+	ser.todo = Make_Series(100, sizeof(SERIAL_TODO), FALSE);
+
+	// Make the words (ahead, as they may expand the word table):
+	// (local index zero is no symbol)
+	ser.syms = Make_Series(head.count + 1, sizeof(REBCNT), FALSE);
+	SERIAL_SYMS(&ser)[0] = 0;
+	cp = data + head.symbols;
+	for (n = 1; n <= head.count; n++) {
+		ep = memchr(cp, 0, len - (cp - data));
+		if (!ep || ep == cp) Trap0(RE_BAD_SERIAL);
+		SERIAL_SYMS(&ser)[n] = Make_Word(cp, (REBCNT)(ep - cp));
+		cp = ep + 1;
+	}
+	ser.syms->tail = head.count;
+
+	val = head.value;
+	Deserial_Cell(&ser, &val, 0, 0);
+	*out = val;
+
+	// Decode the blocks queued above (the queue grows as it goes).
+	// Each cell is taken out and replaced by an END, then put back
+	// once decoded, so the block only ever holds valid values:
+	for (n = 0; n < SERIES_TAIL(ser.todo); n++) {
+		todo = SERIAL_TODOS(&ser)[n];
+		if (todo.kind == SERIAL_FRAME && (!todo.tail || !IS_FRAME(&todo.first)))
+			Trap0(RE_BAD_SERIAL);
+		val = todo.first;
+		for (i = 0; i < todo.tail; i++) {
+			Deserial_Cell(&ser, &val, &todo, i);
+			cell = BLK_SKIP(todo.series, i);
+			*cell++ = val;
+			if (i + 1 < todo.tail) {
+				val = *cell;
+				SET_END(cell);
+			}
+			todo.series->tail = i + 1;
+		}
+		if (todo.kind == SERIAL_MAP) Block_As_Map(todo.series);
+	}
+}
@@ -33,6 +33,7 @@
 
 #include "sys-core.h"
 #include "sys-scan.h"
+#include "sys-simd.h"
 
 // In UTF8 C0, C1, F5, and FF are invalid.
 #ifdef USE_UNICODE
@@ -299,6 +300,67 @@
 #endif
 
 
+/***********************************************************************
+**
+**	Vector Prescan
+**
+**	Long runs of whitespace, comments and plain string text are
+**	found 16 bytes at a time with SSE2 where the compiler has it.
+**	Each block load is aligned, so it never crosses a page, and
+**	the zero that terminates the source always stops the run. The
+**	vector sets are subsets of the Lex_Map classes, so the scalar
+**	loops that follow finish any run the vector did not. (Words
+**	are too short on average to gain from it.)
+**
+***********************************************************************/
+
+#ifdef USE_SSE2
+
+#define STOP_MASK(v) ((unsigned int)~_mm_movemask_epi8(v) & 0xFFFF)
+
+static unsigned int Space_Stops(__m128i v)
+{
+	// Stop at all but space and tab:
+	return STOP_MASK(_mm_or_si128(IS_CHR(v, ' '), IS_CHR(v, '\t')));
+}
+
+static unsigned int Newline_Stops(__m128i v)
+{
+	// Stop at end of line or end of source:
+	__m128i s = _mm_or_si128(IS_CHR(v, LF), IS_CHR(v, CR));
+	return _mm_movemask_epi8(_mm_or_si128(s, IS_CHR(v, 0)));
+}
+
+static unsigned int Quote_Stops(__m128i v)
+{
+	// Stop at chars that Scan_Quote must handle itself:
+	__m128i s = _mm_or_si128(IS_CHR(v, '"'), IS_CHR(v, '^'));
+	s = _mm_or_si128(s, _mm_or_si128(IS_CHR(v, '{'), IS_CHR(v, '}')));
+	s = _mm_or_si128(s, _mm_or_si128(IS_CHR(v, LF), IS_CHR(v, CR)));
+	s = _mm_or_si128(s, IS_CHR(v, 0));
+	return _mm_movemask_epi8(_mm_or_si128(s, v)); // or UTF-8 (high bit)
+}
+
+static REBYTE *Skip_Run(REBYTE *cp, unsigned int (*stops)(__m128i))
+{
+	// Return the first stop char at or after cp:
+	REBYTE *bp = (REBYTE *)((REBUPT)cp & ~(REBUPT)15);
+	unsigned int mask = stops(_mm_load_si128((__m128i *)bp)) >> (cp - bp);
+
+	if (mask) return cp + Lowest_Bit(mask);
+	for (bp += 16; !(mask = stops(_mm_load_si128((__m128i *)bp))); bp += 16);
+	return bp + Lowest_Bit(mask);
+}
+
+#define SKIP_SPACE(cp)   cp = Skip_Run(cp, Space_Stops)
+#define SKIP_LINE(cp)    cp = Skip_Run(cp, Newline_Stops)
+
+#else
+#define SKIP_SPACE(cp)   do {} while (0)
+#define SKIP_LINE(cp)    do {} while (0)
+#endif
+
+
 /***********************************************************************
 **
 */  static REBINT Scan_Char(REBYTE **bp)
@@ -410,14 +472,31 @@
 	REBUNI term;
 	REBINT chr;
 	REBCNT lines = 0;
-	REBSER *buf = BUF_MOLD;
+	REBSER *buf = 0;
 
-	RESET_TAIL(buf);
+	// Scan ahead workers only find the end (BUF_MOLD is not theirs):
+	if (!scan_state || !GET_FLAG(scan_state->opts, SCAN_LEX)) {
+		buf = BUF_MOLD;
+		RESET_TAIL(buf);
+	}
 
 	term = (*src++ == '{') ? '}' : '"';	// pick termination
 
 	while (*src != term || nest > 0) {
 
+#ifdef USE_SSE2
+		// Copy a run of plain ASCII chars at once:
+		if (NZ(chr = Skip_Run(src, Quote_Stops) - src)) {
+			REBUNI *up;
+			if (!buf) {src += chr; continue;}
+			if (buf->tail + chr >= SERIES_REST(buf)) Extend_Series(buf, chr);
+			up = UNI_SKIP(buf, buf->tail);
+			buf->tail += chr;
+			for (; chr > 0; chr--) *up++ = *src++;
+			continue;
+		}
+#endif
+
 		chr = *src;
 
         switch (chr) {
@@ -457,6 +536,8 @@
 
 		src++;
 
+		if (!buf) continue;
+
 		*UNI_SKIP(buf, buf->tail) = chr;
 
 		if (++(buf->tail) >= SERIES_REST(buf)) Extend_Series(buf, 1);
@@ -466,7 +547,7 @@
 
 	if (scan_state) scan_state->line_count += lines;
 
-	UNI_TERM(buf);
+	if (buf) UNI_TERM(buf);
 
 	return src;
 }
@@ -640,6 +721,7 @@
     REBYTE *cp = scan_state->begin; /* char scan pointer */
     REBCNT flags = 0;               /* lexical flags */
 
+    if (IS_LEX_SPACE(cp[0]) && IS_LEX_SPACE(cp[1])) SKIP_SPACE(cp); /* indents */
     while (IS_LEX_SPACE(*cp)) cp++; /* skip white space */
     scan_state->begin = cp;         /* start of lexical symbol */
 
@@ -701,6 +783,7 @@
         switch (GET_LEX_VALUE(*cp)) {
         case LEX_DELIMIT_SPACE:         /* white space (pre-processed above) */
         case LEX_DELIMIT_SEMICOLON:     /* ; begin comment */
+            SKIP_LINE(cp);
             while (NOT_NEWLINE(*cp)) cp++;
             if (!*cp) cp--;             /* avoid passing EOF  */
 			if (*cp == LF) goto line_feed;
@@ -1048,10 +1131,234 @@ scanword:
     scan_state->line_count = 1;
 	scan_state->opts = 0;
 	scan_state->errors = 0;
+	scan_state->ahead = 0;
+	scan_state->token = 0;
 //    scan_state->error_id = (REBYTE *)"";
 }
 
 
+/***********************************************************************
+**
+**	Parallel Scan Ahead
+**
+**		Used by transcode/parallel (and load/parallel) for large
+**		sources. Values, series and the word table can only be made
+**		by the interpreter's thread, but the lexical work of
+**		Scan_Token and the hashing of word names can be done ahead.
+**		The source past the scan point is split into chunks at line
+**		starts, the chunks are tokenized by workers (OS_RUN_JOBS),
+**		and Scan_Block then takes its tokens from the results.
+**
+**		A token depends only on the source from where its scan
+**		begins, so the results are looked up by that offset. A split
+**		inside a multi-line string, or a token that Scan_Block takes
+**		apart itself (paths, dates), just misses and falls back to
+**		Scan_Token. Strings are not kept (they must be decoded into
+**		BUF_MOLD), nor other tokens that count lines.
+**
+***********************************************************************/
+
+#ifdef HAS_THREADS
+
+#define SCAN_WORKERS	4				// chunks tokenized at once
+#define SCAN_CHUNK_SIZE	0x20000			// source bytes per chunk
+#define SCAN_TOKENS		(SCAN_CHUNK_SIZE / 4) // tokens kept per chunk
+#define MIN_SCAN_AHEAD	(2 * SCAN_CHUNK_SIZE) // smaller is not worth it
+
+typedef struct rebol_scan_token {
+	REBCNT start;		// offset the scan began at
+	REBCNT begin;		// offset of the token (past white space)
+	REBCNT end;
+	REBINT type;		// as returned by Scan_Token
+	REBINT hash;		// Hash_Word of the name of word tokens
+} SCAN_TOKEN;
+
+typedef struct rebol_scan_chunk {
+	REBYTE *src;		// source head (offsets are from here)
+	REBCNT start;		// offset of first scan
+	REBCNT limit;		// no scans start here or after
+	REBCNT count;		// tokens found
+	SCAN_TOKEN *tokens;
+} SCAN_CHUNK;
+
+typedef struct rebol_scan_ahead {
+	REBYTE *src;
+	REBCNT len;
+	REBCNT next;		// offset where next chunks must be scanned
+	REBCNT used;		// chunks scanned
+	REBCNT chunk;		// chunk and token of last lookup
+	REBCNT index;
+	SCAN_CHUNK chunks[SCAN_WORKERS];
+} SCAN_AHEAD;
+
+static SCAN_TOKEN *Scan_Tokens;	// kept for later scans
+
+
+/***********************************************************************
+**
+*/  static void Scan_Chunk(void *arg)
+/*
+**		Worker job: tokenize a chunk of source. Must not use any
+**		interpreter state (BUF_MOLD, series, words).
+**
+***********************************************************************/
+{
+	SCAN_CHUNK *chunk = arg;
+	SCAN_TOKEN *tok = chunk->tokens;
+	SCAN_STATE scan_state;
+	REBYTE *limit = chunk->src + chunk->limit;
+	REBYTE *bp;
+	REBCNT len;
+	REBCNT lines;
+	REBINT type;
+
+	chunk->count = 0;
+	Init_Scan_State(&scan_state, chunk->src + chunk->start, chunk->limit - chunk->start);
+	SET_FLAG(scan_state.opts, SCAN_LEX);
+
+	while (scan_state.begin < limit && chunk->count < SCAN_TOKENS) {
+		tok->start = (REBCNT)(scan_state.begin - chunk->src);
+		lines = scan_state.line_count;
+		type = Scan_Token(&scan_state);
+		if (type == TOKEN_EOF || scan_state.end <= scan_state.begin) break;
+		lines = scan_state.line_count - lines;
+
+		if (type != TOKEN_STRING && lines == (REBCNT)(type == TOKEN_LINE)) {
+			bp = scan_state.begin;
+			len = (REBCNT)(scan_state.end - bp);
+			tok->begin = (REBCNT)(bp - chunk->src);
+			tok->end = tok->begin + len;
+			tok->type = type;
+			// Hash the same name Scan_Block gives to Make_Word:
+			switch (type) {
+			case TOKEN_GET:
+			case TOKEN_LIT:
+				if (bp[len-1] == ':') len--;
+			case TOKEN_REFINE:
+				bp++, len--;
+				tok->hash = Hash_Word(bp, len);
+				break;
+			case TOKEN_SET:
+				len--;
+			case TOKEN_WORD:
+				tok->hash = Hash_Word(bp, len);
+				break;
+			default:
+				tok->hash = 0; // (not a word)
+			}
+			tok++;
+			chunk->count++;
+		}
+
+		ACCEPT_TOKEN(&scan_state);
+	}
+}
+
+
+/***********************************************************************
+**
+*/  static void Scan_Ahead(SCAN_AHEAD *ahead, REBCNT pos)
+/*
+**		Tokenize the chunks of source that follow pos.
+**
+***********************************************************************/
+{
+	SCAN_CHUNK *chunk = ahead->chunks;
+	REBYTE *cp;
+	REBCNT n;
+
+	ahead->used = ahead->chunk = ahead->index = 0;
+
+	// Let the end be scanned directly:
+	if (ahead->len - pos < MIN_SCAN_AHEAD) {
+		ahead->next = ahead->len + 1; // no more
+		return;
+	}
+
+	for (n = 0; n < SCAN_WORKERS && pos < ahead->len; n++, chunk++) {
+		chunk->src = ahead->src;
+		chunk->tokens = Scan_Tokens + n * SCAN_TOKENS;
+		chunk->start = pos;
+		pos += MIN(SCAN_CHUNK_SIZE, ahead->len - pos);
+		// Split after a line end, if one is near:
+		for (cp = ahead->src + pos; *cp && *cp != LF && cp < ahead->src + pos + 256; cp++);
+		if (*cp == LF) pos = (REBCNT)(cp + 1 - ahead->src);
+		chunk->limit = MIN(pos, ahead->len);
+	}
+
+	ahead->used = n;
+	ahead->next = ahead->chunks[n-1].limit;
+
+	OS_RUN_JOBS(Scan_Chunk, ahead->chunks, sizeof(SCAN_CHUNK), n);
+}
+
+
+/***********************************************************************
+**
+*/  static REBINT Next_Token(SCAN_STATE *scan_state)
+/*
+**		Scan_Token, using the tokens found ahead when possible.
+**
+***********************************************************************/
+{
+	SCAN_AHEAD *ahead = scan_state->ahead;
+	REBCNT pos = (REBCNT)(scan_state->begin - ahead->src);
+	SCAN_CHUNK *chunk;
+	SCAN_TOKEN *tok;
+
+	scan_state->token = 0;
+
+	if (pos >= ahead->next) Scan_Ahead(ahead, pos);
+
+	for (; ahead->chunk < ahead->used; ahead->chunk++, ahead->index = 0) {
+		chunk = &ahead->chunks[ahead->chunk];
+		for (; ahead->index < chunk->count; ahead->index++) {
+			tok = chunk->tokens + ahead->index;
+			if (tok->start < pos) continue;
+			if (tok->start > pos) return Scan_Token(scan_state);
+			scan_state->begin = ahead->src + tok->begin;
+			scan_state->end = ahead->src + tok->end;
+			if (tok->type == TOKEN_LINE) scan_state->line_count++;
+			scan_state->token = tok;
+			return tok->type;
+		}
+	}
+
+	return Scan_Token(scan_state);
+}
+
+
+/***********************************************************************
+**
+*/  static void Init_Scan_Ahead(SCAN_STATE *scan_state, SCAN_AHEAD *ahead)
+/*
+**		Let the scan use workers, if the source is large enough.
+**
+***********************************************************************/
+{
+	ahead->src = scan_state->begin;
+	ahead->len = (REBCNT)(scan_state->limit - scan_state->begin);
+	if (ahead->len < MIN_SCAN_AHEAD) return;
+
+	if (!Scan_Tokens)
+		Scan_Tokens = Make_Mem(SCAN_WORKERS * SCAN_TOKENS * sizeof(SCAN_TOKEN));
+
+	ahead->next = ahead->used = 0;
+	scan_state->ahead = ahead;
+}
+
+#define NEXT_TOKEN(s) ((s)->ahead ? Next_Token(s) : Scan_Token(s))
+#define MAKE_WORD(s, bp, len) ((s)->token ? \
+	Make_Word_Hash(bp, len, (s)->token->hash) : Make_Word(bp, len))
+
+#else
+
+#define NEXT_TOKEN(s) Scan_Token(s)
+#define MAKE_WORD(s, bp, len) Make_Word(bp, len)
+
+#endif
+
+
 /***********************************************************************
 **
 */	static REBINT Scan_Head(SCAN_STATE *scan_state)
@@ -1185,7 +1492,7 @@ extern REBSER *Scan_Full_Block(SCAN_STATE *scan_state, REBYTE mode_char);
 #ifdef COMP_LINES
 		linenum=scan_state->line_count,
 #endif
-		((token = Scan_Token(scan_state)) != TOKEN_EOF)
+		((token = NEXT_TOKEN(scan_state)) != TOKEN_EOF)
 	) {
 
 		bp = scan_state->begin;
@@ -1273,13 +1580,13 @@ extern REBSER *Scan_Full_Block(SCAN_STATE *scan_state, REBYTE mode_char);
 		case TOKEN_WORD:
 			if (len == 0) {bp--; goto syntax_error;}
 			VAL_SET(value, (REBYTE)(REB_WORD + (token - TOKEN_WORD))); // NO_FRAME
-			if (!(VAL_WORD_SYM(value) = Make_Word(bp, len))) goto syntax_error;
+			if (!(VAL_WORD_SYM(value) = MAKE_WORD(scan_state, bp, len))) goto syntax_error;
 			VAL_WORD_FRAME(value) = 0;
 			break;
 
 		case TOKEN_REFINE:
 			VAL_SET(value, REB_REFINEMENT); // NO_FRAME
-			if (!(VAL_WORD_SYM(value) = Make_Word(bp+1, len-1))) goto syntax_error;
+			if (!(VAL_WORD_SYM(value) = MAKE_WORD(scan_state, bp+1, len-1))) goto syntax_error;
 			break;
 
 		case TOKEN_ISSUE:
@@ -1618,12 +1925,18 @@ exit_block:
 {
 	REBSER *blk;
     SCAN_STATE scan_state;
+#ifdef HAS_THREADS
+	SCAN_AHEAD ahead;
+#endif
 
     Init_Scan_State(&scan_state, VAL_BIN_DATA(D_ARG(1)), VAL_LEN(D_ARG(1)));
 
 	if (D_REF(2)) SET_FLAG(scan_state.opts, SCAN_NEXT);
 	if (D_REF(3)) SET_FLAG(scan_state.opts, SCAN_ONLY);
 	if (D_REF(4)) SET_FLAG(scan_state.opts, SCAN_RELAX);
+#ifdef HAS_THREADS
+	if (D_REF(5) && !D_REF(2) && !D_REF(3)) Init_Scan_Ahead(&scan_state, &ahead);
+#endif
 
 	blk = Scan_Code(&scan_state, 0);
 	DS_RELOAD(ds); // in case stack moved
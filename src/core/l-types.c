@@ -251,24 +251,53 @@ bad_hex:	Trap0(RE_INVALID_CHARS);
 	REBYTE *ep = buf;
 	REBOOL dig = FALSE;   /* flag that a digit was present */
 	char *se;
+	REBU64 w = 0;         /* leading significant digits, while they fit */
+	REBINT nd = 0;        /* count of them */
+	REBINT q = 0;         /* power of ten to scale w by */
+	REBINT ex = 0;
+	REBOOL neg = FALSE, eneg = FALSE;
+	REBOOL exact = TRUE;  /* no digits were dropped from w */
+	REBDEC d;
 
 	if (len > MAX_NUM_LEN) return 0;
 
-	if (*cp == '+' || *cp == '-') *ep++ = *cp++;
-	while (IS_LEX_NUMBER(*cp) || *cp == '\'')
-		if (*cp != '\'') *ep++ = *cp++, dig=1;
+	if (*cp == '+' || *cp == '-') neg = (*cp == '-'), *ep++ = *cp++;
+	while (IS_LEX_NUMBER(*cp) || *cp == '\'') {
+		if (*cp != '\'') {
+			if (nd < 19) {
+				w = w * 10 + (*cp - '0');
+				if (w) nd++;
+			} else {
+				q++;
+				if (*cp != '0') exact = FALSE;
+			}
+			*ep++ = *cp++, dig=1;
+		}
 		else cp++;
+	}
 	if (*cp == ',' || *cp == '.') cp++;
 	*ep++ = '.';
-	while (IS_LEX_NUMBER(*cp) || *cp == '\'')
-		if (*cp != '\'') *ep++ = *cp++, dig=1;
+	while (IS_LEX_NUMBER(*cp) || *cp == '\'') {
+		if (*cp != '\'') {
+			if (nd < 19) {
+				w = w * 10 + (*cp - '0');
+				if (w) nd++;
+				q--;
+			}
+			else if (*cp != '0') exact = FALSE;
+			*ep++ = *cp++, dig=1;
+		}
 		else cp++;
+	}
 	if (!dig) return 0;
 	if (*cp == 'E' || *cp == 'e') {
 			*ep++ = *cp++;
 			dig = 0;
-			if (*cp == '-' || *cp == '+') *ep++ = *cp++;
-			while (IS_LEX_NUMBER(*cp)) *ep++ = *cp++, dig=1;
+			if (*cp == '-' || *cp == '+') eneg = (*cp == '-'), *ep++ = *cp++;
+			while (IS_LEX_NUMBER(*cp)) {
+				if (ex < 100000) ex = ex * 10 + (*cp - '0');
+				*ep++ = *cp++, dig=1;
+			}
 			if (!dig) return 0;
 	}
 	if (*cp == '%') {
@@ -280,7 +309,11 @@ bad_hex:	Trap0(RE_INVALID_CHARS);
 	if ((REBCNT)(cp-bp) != len) return 0;
 
 	VAL_SET(value, REB_DECIMAL);
-	VAL_DECIMAL(value) = STRTOD((char *)buf, &se); // need check for NaN, and INF !!!
+	// Most numbers convert directly; the rest need the exact method:
+	if (exact && Fast_Strtod(w, eneg ? q - ex : q + ex, &d))
+		VAL_DECIMAL(value) = neg ? -d : d;
+	else
+		VAL_DECIMAL(value) = STRTOD((char *)buf, &se); // need check for NaN, and INF !!!
 	if (fabs(VAL_DECIMAL(value)) == HUGE_VAL) Trap0(RE_OVERFLOW);
 	return cp;
 }
@@ -813,7 +846,7 @@ end_date:
 	if (*cp++ != '{') return 0;
 	len -= 2;
 
-	cp = Decode_Binary(value, cp, len, base, '}');
+	cp = Decode_Binary(value, cp, len, base, '}', FALSE);
 	if (!cp) return 0;
 
 	cp = Skip_To_Char(cp, cp + len, '}');
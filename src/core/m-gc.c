@@ -514,6 +514,28 @@ mark_obj:
 }
 
 
+/***********************************************************************
+**
+*/	static void Sweep_Finals(void)
+/*
+**		Free the outside memory of series that are not marked
+**		(so are about to be swept).
+**
+***********************************************************************/
+{
+	FINAL_MEM *final;
+	REBCNT n;
+
+	for (n = SERIES_TAIL(GC_Finals); n > 0; n--) {
+		final = (FINAL_MEM *)SERIES_DATA(GC_Finals) + n - 1;
+		if (IS_FREEABLE(final->owner)) {
+			final->free_func(final->data);
+			Remove_Series(GC_Finals, n - 1, 1);
+		}
+	}
+}
+
+
 /***********************************************************************
 **
 */	REBCNT Recycle(void)
@@ -583,6 +605,7 @@ mark_obj:
 	// Mark all devices:
 	Mark_Devices(0);
 	
+	Sweep_Finals();
 	count = Sweep_Series();
 	count += Sweep_Gobs();
 
@@ -651,6 +674,63 @@ mark_obj:
 }
 
 
+/***********************************************************************
+**
+*/	void Guard_Final(REBSER *owner, void *data, void (*free_func)(void *))
+/*
+**		Memory outside of series, used by the owner series. Unless
+**		Loose_Final is called first, free_func is called with the data
+**		when the owner is collected.
+**
+***********************************************************************/
+{
+	FINAL_MEM *final;
+
+	EXPAND_SERIES_TAIL(GC_Finals, 1);
+	final = (FINAL_MEM *)SERIES_DATA(GC_Finals) + SERIES_TAIL(GC_Finals) - 1;
+	final->owner = owner;
+	final->data = data;
+	final->free_func = free_func;
+}
+
+
+/***********************************************************************
+**
+*/	void *Find_Final(REBSER *owner)
+/*
+**		Return the outside memory of the owner series, or zero.
+**
+***********************************************************************/
+{
+	FINAL_MEM *final = (FINAL_MEM *)SERIES_DATA(GC_Finals);
+	REBCNT n;
+
+	for (n = 0; n < SERIES_TAIL(GC_Finals); n++, final++)
+		if (final->owner == owner) return final->data;
+	return 0;
+}
+
+
+/***********************************************************************
+**
+*/	void Loose_Final(void *data)
+/*
+**		Remove the memory from the list (the caller frees it).
+**
+***********************************************************************/
+{
+	FINAL_MEM *final = (FINAL_MEM *)SERIES_DATA(GC_Finals);
+	REBCNT n;
+
+	for (n = 0; n < SERIES_TAIL(GC_Finals); n++, final++) {
+		if (final->data == data) {
+			Remove_Series(GC_Finals, n, 1);
+			break;
+		}
+	}
+}
+
+
 /***********************************************************************
 **
 */	void Init_Memory(REBINT scale)
@@ -676,4 +756,12 @@ mark_obj:
 
 	GC_Series = Make_Series(60, sizeof(REBSER *), FALSE);
 	KEEP_SERIES(GC_Series, "gc guarded");
+
+	// Files mapped into memory (see Make_Mapped_Binary):
+	GC_Mapped = Make_Series(8, sizeof(MAPPED_FILE), FALSE);
+	KEEP_SERIES(GC_Mapped, "gc mapped");
+
+	// Memory freed with its owner series (see Guard_Final):
+	GC_Finals = Make_Series(8, sizeof(FINAL_MEM), FALSE);
+	KEEP_SERIES(GC_Finals, "gc finals");
 }
@@ -437,6 +437,128 @@ const REBPOOLSPEC Mem_Pool_Spec[MAX_POOLS] =
 }
 
 
+/***********************************************************************
+**
+*/	static MAPPED_FILE *Find_Mapped_File(REBYTE *data)
+/*
+**		Return the mapped file that holds the data, or zero.
+**
+***********************************************************************/
+{
+	MAPPED_FILE *file = (MAPPED_FILE *)SERIES_DATA(GC_Mapped);
+	REBCNT n;
+
+	for (n = 0; n < SERIES_TAIL(GC_Mapped); n++, file++) {
+		if (data >= file->data && data < file->data + file->size) return file;
+	}
+
+	return 0;
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Make_Ext_Series(REBYTE *data, REBCNT len, REBCNT wide)
+/*
+**		Make a series header for data outside of the pools.
+**		The data must be terminated.
+**
+***********************************************************************/
+{
+	REBSER *series;
+
+	PG_Reb_Stats->Series_Made++;
+
+	series = (REBSER *)Make_Node(SERIES_POOL);
+	series->tail = len;
+	series->size = 0;
+	SERIES_REST(series) = len + 1;
+	series->data = data;
+	series->info = wide; // also clears flags
+	SERIES_SET_FLAG(series, SER_EXT);
+	LABEL_SERIES(series, "mapped");
+
+	// Keep the last few series in the nursery, safe from GC:
+	if (GC_Last_Infant >= MAX_SAFE_SERIES) GC_Last_Infant = 0;
+	GC_Infants[GC_Last_Infant++] = series;
+
+	return series;
+}
+
+
+/***********************************************************************
+**
+*/	REBSER *Make_Mapped_Binary(REBYTE *data, REBCNT len)
+/*
+**		Make a binary series that uses a memory mapped file as
+**		its data. The mapping must have room for a terminator
+**		at len. The data is unmapped when the series is freed,
+**		and is copied to normal memory if the series expands.
+**
+***********************************************************************/
+{
+	MAPPED_FILE *file;
+
+	EXPAND_SERIES_TAIL(GC_Mapped, 1);
+	file = (MAPPED_FILE *)SERIES_DATA(GC_Mapped) + SERIES_TAIL(GC_Mapped) - 1;
+	file->data = data;
+	file->size = len + 1;
+	file->refs = 1;
+
+	return Make_Ext_Series(data, len, 1);
+}
+
+
+/***********************************************************************
+**
+*/	REBSER *Make_Mapped_Series(REBYTE *data, REBCNT len, REBCNT wide)
+/*
+**		Make a series of any width whose data is part of a file
+**		already mapped by Make_Mapped_Binary. The data must be
+**		terminated. The file stays mapped until all the series
+**		that use it are freed. Returns zero if the data is not
+**		in a mapped file.
+**
+**		Pages are private to this process, so changes to the
+**		series data are copied on write (never to the file).
+**
+***********************************************************************/
+{
+	MAPPED_FILE *file = Find_Mapped_File(data);
+
+	if (!file || data + (len + 1) * wide > file->data + file->size) return 0;
+	file->refs++;
+
+	return Make_Ext_Series(data, len, wide);
+}
+
+
+/***********************************************************************
+**
+*/	REBSER *Take_Mapped_Series(REBSER *series)
+/*
+**		Move the mapped data of a series to a new series header,
+**		leaving the series empty (in pool memory). Used when the
+**		mapped data is about to be reused in place, so it must
+**		no longer be seen by the original series.
+**
+***********************************************************************/
+{
+	REBSER *taken = Make_Ext_Series(series->data, series->tail, SERIES_WIDE(series));
+
+	taken->info = series->info;
+	taken->size = series->size;
+	SERIES_REST(taken) = SERIES_REST(series);
+
+	SERIES_CLR_FLAG(series, SER_EXT);
+	SERIES_SET_BIAS(series, 0);
+	Make_Series_Data(series, 1);
+	TERM_SERIES(series);
+
+	return taken;
+}
+
+
 /***********************************************************************
 **
 */	void Free_Series_Data(REBSER *series, REBOOL protect)
@@ -450,11 +572,22 @@ const REBPOOLSPEC Mem_Pool_Spec[MAX_POOLS] =
 	REBPOL *pool;
 	REBCNT pool_num;
 	REBCNT size;
+	MAPPED_FILE *file;
 
 	// !!!! Dump_Series(series, "Free-Data");
 
 	if (SERIES_FREED(series) || series->data == BAD_MEM_PTR) return; // No free twice.
-	if (IS_EXT_SERIES(series)) goto clear_header;  // Must be library related
+	if (IS_EXT_SERIES(series)) {
+		// Data is in a mapped file (see Make_Mapped_Binary):
+		series->data -= SERIES_WIDE(series) * SERIES_BIAS(series);
+		file = Find_Mapped_File(series->data);
+		if (file && !--file->refs) {
+			OS_UNMAP_FILE(file->data, file->size);
+			Remove_Series(GC_Mapped, file - (MAPPED_FILE *)SERIES_DATA(GC_Mapped), 1);
+		}
+		SERIES_CLR_FLAG(series, SER_EXT);
+		goto clear_header;
+	}
 
 	size = SERIES_TOTAL(series);
 	if ((GC_Ballast += size) > VAL_INT32(TASK_BALLAST))
@@ -560,6 +693,7 @@ clear_header:
 ***********************************************************************/
 {
 	newser->info = oldser->info;
+	SERIES_CLR_FLAG(newser, SER_EXT); // new data is never mapped
 	newser->size = oldser->size;
 #ifdef SERIES_LABELS
 	newser->label = oldser->label;
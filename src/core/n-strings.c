@@ -29,58 +29,18 @@
 
 #include "sys-core.h"
 #include "sys-deci-funcs.h"
+#include "sys-digest.h"
 
 
-/***********************************************************************
-**
-**	Hash Function Externs
-**
-***********************************************************************/
-
-#ifndef SHA_DEFINED
-#ifdef HAS_SHA1
-REBYTE *SHA1(REBYTE *, REBCNT, REBYTE *);
-void SHA1_Init(void *c);
-void SHA1_Update(void *c, REBYTE *data, REBCNT len);
-void SHA1_Final(REBYTE *md, void *c);
-int  SHA1_CtxSize(void);
-#endif
-#endif
-
-#ifndef MD5_DEFINED
-#ifdef HAS_MD5
-REBYTE *MD5(REBYTE *, REBCNT, REBYTE *);
-void MD5_Init(void *c);
-void MD5_Update(void *c, REBYTE *data, REBCNT len);
-void MD5_Final(REBYTE *md, void *c);
-int  MD5_CtxSize(void);
-#endif
-#endif
-
-#ifdef HAS_MD4
-REBYTE *MD4(REBYTE *, REBCNT, REBYTE *);
-void MD4_Init(void *c);
-void MD4_Update(void *c, REBYTE *data, REBCNT len);
-void MD4_Final(REBYTE *md, void *c);
-int  MD4_CtxSize(void);
-#endif
-
-// Table of has functions and parameters:
-static struct digest {
-	REBYTE *(*digest)(REBYTE *, REBCNT, REBYTE *);
-	void (*init)(void *);
-	void (*update)(void *, REBYTE *, REBCNT);
-	void (*final)(REBYTE *, void *);
-	int (*ctxsize)(void);
-	REBINT index;
-	REBINT len;
-	REBINT hmacblock;
-} digests[] = {
+// Table of hash functions and parameters (see sys-digest.h):
+REBDIG Digests[] = {
 
 #ifdef HAS_SHA1
 	{SHA1, SHA1_Init, SHA1_Update, SHA1_Final, SHA1_CtxSize, SYM_SHA1, 20, 64},
 #endif
 
+	{SHA256, SHA256_Init, SHA256_Update, SHA256_Final, SHA256_CtxSize, SYM_SHA256, 32, 64},
+
 #ifdef HAS_MD4
 	{MD4, MD4_Init, MD4_Update, MD4_Final, MD4_CtxSize, SYM_MD4, 16, 64},
 #endif
@@ -154,7 +114,7 @@ static struct digest {
 **		/hash {Returns a hash value}
 **		size [integer!] {Size of the hash table}
 **		/method {Method to use}
-**		word [word!] {Method: SHA1 MD5}
+**		word [word!] {Method: SHA1 SHA256 MD5 CRC32 CRC32C}
 **		/key {Returns keyed HMAC value}
 **		key-value [any-string!] {Key to use}
 **
@@ -177,33 +137,33 @@ static struct digest {
 	// If method, secure, or key... find matching digest:
 	if (D_REF(ARG_CHECKSUM_METHOD) || D_REF(ARG_CHECKSUM_SECURE) || D_REF(ARG_CHECKSUM_KEY)) {
 
-		if (sym == SYM_CRC32) {
+		if (sym == SYM_CRC32 || sym == SYM_CRC32C) {
 			if (D_REF(ARG_CHECKSUM_SECURE) || D_REF(ARG_CHECKSUM_KEY)) Trap0(RE_BAD_REFINES);
-			i = CRC32(data, len);
+			i = (sym == SYM_CRC32) ? CRC32(data, len) : Update_CRC32C(0, data, len);
 			DS_RET_INT(i);
 			return R_RET;
 		}
 
-		for (i = 0; i < sizeof(digests) / sizeof(digests[0]); i++) {
+		for (i = 0; i < sizeof(Digests) / sizeof(Digests[0]); i++) {
 
-			if (digests[i].index == sym) {
+			if (Digests[i].index == sym) {
 
-				digest = Make_Series(digests[i].len, 1, FALSE);
+				digest = Make_Series(Digests[i].len, 1, FALSE);
 				LABEL_SERIES(digest, "checksum digest");
 
 				if (D_REF(ARG_CHECKSUM_KEY)) {
-					REBYTE tmpdigest[20];		// Size must be max of all digest[].len;
-					REBYTE ipad[64],opad[64];	// Size must be max of all digest[].hmacblock;
-					void *ctx = Make_Mem(digests[i].ctxsize());
+					REBYTE tmpdigest[MAX_DIGEST_LEN];
+					REBYTE ipad[MAX_DIGEST_BLOCK],opad[MAX_DIGEST_BLOCK];
+					void *ctx = Make_Mem(Digests[i].ctxsize());
 					REBVAL *key = D_ARG(ARG_CHECKSUM_KEY_VALUE);
 					REBYTE *keycp = VAL_BIN_DATA(key);
 					int keylen = VAL_LEN(key);
-					int blocklen = digests[i].hmacblock;
+					int blocklen = Digests[i].hmacblock;
 
 					if (keylen > blocklen) {
-						digests[i].digest(keycp,keylen,tmpdigest);
+						Digests[i].digest(keycp,keylen,tmpdigest);
 						keycp = tmpdigest;
-						keylen = digests[i].len;
+						keylen = Digests[i].len;
 					}
 
 					memset(ipad, 0, blocklen);
@@ -216,22 +176,22 @@ static struct digest {
 						opad[j]^=0x5c;
 					}
 
-					digests[i].init(ctx);
-					digests[i].update(ctx,ipad,blocklen);
-					digests[i].update(ctx, data, len);
-					digests[i].final(tmpdigest,ctx);
-					digests[i].init(ctx);
-					digests[i].update(ctx,opad,blocklen);
-					digests[i].update(ctx,tmpdigest,digests[i].len);
-					digests[i].final(BIN_HEAD(digest),ctx);
+					Digests[i].init(ctx);
+					Digests[i].update(ctx,ipad,blocklen);
+					Digests[i].update(ctx, data, len);
+					Digests[i].final(tmpdigest,ctx);
+					Digests[i].init(ctx);
+					Digests[i].update(ctx,opad,blocklen);
+					Digests[i].update(ctx,tmpdigest,Digests[i].len);
+					Digests[i].final(BIN_HEAD(digest),ctx);
 
-					Free_Mem(ctx, digests[i].ctxsize());
+					Free_Mem(ctx, Digests[i].ctxsize());
 
 				} else {
-					digests[i].digest(data, len, BIN_HEAD(digest));
+					Digests[i].digest(data, len, BIN_HEAD(digest));
 				}
 
-				SERIES_TAIL(digest) = digests[i].len;
+				SERIES_TAIL(digest) = Digests[i].len;
 				Set_Series(REB_BINARY, DS_RETURN, digest);
 
 				return 0;
@@ -302,6 +262,42 @@ static struct digest {
 }
 
 
+/***********************************************************************
+**
+*/	REBNATIVE(serialize)
+/*
+***********************************************************************/
+{
+	Set_Binary(D_RET, Serialize_Value(D_ARG(1)));
+
+	return R_RET;
+}
+
+
+/***********************************************************************
+**
+*/	REBNATIVE(deserialize)
+/*
+**		With /mapped, a binary that is a mapped file (from READ)
+**		is decoded in place, and the binary is left empty.
+**
+***********************************************************************/
+{
+	REBVAL *arg = D_ARG(1);
+	REBSER *ser = VAL_SERIES(arg);
+	REBYTE *data = VAL_BIN_DATA(arg);
+	REBCNT len = VAL_LEN(arg);
+	REBFLG mapped;
+
+	mapped = D_REF(2) && IS_EXT_SERIES(ser) && !IS_PROTECT_SERIES(ser) && !VAL_INDEX(arg);
+	if (mapped) Take_Mapped_Series(ser);
+
+	Deserialize_Value(data, len, D_RET, mapped);
+
+	return R_RET;
+}
+
+
 /***********************************************************************
 **
 */	REBNATIVE(construct)
@@ -355,7 +351,7 @@ static struct digest {
 
 	if (D_REF(2)) base = VAL_INT32(D_ARG(3)); // /base
 
-	if (!Decode_Binary(D_RET, BIN_SKIP(ser, index), len, base, 0))
+	if (!Decode_Binary(D_RET, BIN_SKIP(ser, index), len, base, 0, D_REF(4)))
  		Trap1(RE_INVALID_DATA, D_ARG(1));
 
 	return R_RET;
@@ -383,7 +379,7 @@ static struct digest {
 
 	switch (base) {
 	case 64:
-		ser = Encode_Base64(arg, 0, FALSE);
+		ser = Encode_Base64(arg, 0, FALSE, D_REF(4)); // /url
 		break;
 	case 16:
 		ser = Encode_Base16(arg, 0, FALSE);
@@ -520,6 +516,110 @@ static struct digest {
 }
 
 
+/***********************************************************************
+**
+*/	REBNATIVE(split)
+/*
+**		Strings split at a char, string, or bitset are done by
+**		Split_String. Sizes, rule blocks, and block input here.
+**
+***********************************************************************/
+{
+	REBVAL *val = D_ARG(1);
+	REBVAL *dlm = D_ARG(2);
+	REBFLG pos = D_REF(4);
+	REBSER *ser = VAL_SERIES(val);
+	REBCNT tail = VAL_TAIL(val);
+	REBCNT index = MIN(VAL_INDEX(val), tail);
+	REBCNT start = index;
+	REBSER *blk;
+	REBVAL *item;
+	REBI64 size;
+	REBCNT n;
+
+	if (!ANY_BINSTR(val) && !ANY_BLOCK(val)) Trap_Arg(val);
+
+	if (ANY_BINSTR(val) && !IS_INTEGER(dlm) && !IS_BLOCK(dlm)) {
+		Set_Block(D_RET, Split_String(val, dlm, pos));
+		return R_RET;
+	}
+
+	blk = Make_Block(8);
+	SAVE_SERIES(blk);
+
+	if (IS_INTEGER(dlm)) {
+		size = VAL_INT64(dlm);
+		if (size < 1) Trap_Arg(dlm);
+		if (D_REF(3)) {
+			// Into size pieces, the last one taking the rest:
+			REBCNT count;
+			n = (tail - index) / (REBCNT)MIN(size, MAX_I32);
+			if (n == 0) n = 1;
+			for (count = 1; count < size && index + n <= tail; count++, index += n)
+				Append_Piece(blk, val, index, index + n, pos);
+			if (count == size) Append_Piece(blk, val, index, tail, pos);
+			else for (; count <= size; count++) Append_Piece(blk, val, tail, tail, pos);
+		}
+		else {
+			for (; index < tail; index = n) {
+				n = (size < tail - index) ? index + (REBCNT)size : tail;
+				Append_Piece(blk, val, index, n, pos);
+			}
+		}
+	}
+	else if (IS_BLOCK(dlm)) {
+		for (item = VAL_BLK_DATA(dlm); IS_INTEGER(item); item++);
+		if (IS_END(item) && VAL_LEN(dlm) > 0) {
+			// Piece sizes (negative skips):
+			for (item = VAL_BLK_DATA(dlm); NOT_END(item); item++) {
+				size = VAL_INT64(item);
+				n = (REBCNT)MIN(size < 0 ? -size : size, tail - index);
+				if (size > 0) Append_Piece(blk, val, index, index + n, pos);
+				index += n;
+			}
+		}
+		else {
+			// At each match of the rules:
+			while (index < tail) {
+				n = Parse_Match(val, index, dlm);
+				tail = VAL_TAIL(val); // (rules may change the input)
+				if (n != NOT_FOUND && n > index && n <= tail) {
+					Append_Piece(blk, val, start, index, pos);
+					index = start = n;
+				}
+				else index++;
+			}
+			if (start < tail) Append_Piece(blk, val, start, tail, pos);
+		}
+	}
+	else {
+		// Block input split at a value:
+		for (; index < tail; index++) {
+			if (!Cmp_Value(BLK_SKIP(ser, index), dlm, FALSE)) {
+				Append_Piece(blk, val, start, index, pos);
+				start = index + 1;
+			}
+		}
+		if (tail > MIN(VAL_INDEX(val), tail)) Append_Piece(blk, val, start, tail, pos);
+	}
+
+	UNSAVE_SERIES(blk);
+	Set_Block(D_RET, blk);
+	return R_RET;
+}
+
+
+/***********************************************************************
+**
+*/	REBNATIVE(split_lines)
+/*
+***********************************************************************/
+{
+	Set_Block(D_RET, Split_String(D_ARG(1), 0, D_REF(2)));
+	return R_RET;
+}
+
+
 /***********************************************************************
 **
 */  REBNATIVE(enline)
@@ -158,6 +158,11 @@
 
 			stats++;
 			SET_INTEGER(stats, PG_Reb_Stats->Recycle_Counter);
+
+			stats++;
+			SET_INTEGER(stats, PG_Reb_Stats->Parse_Memo_Hits);
+			stats++;
+			SET_INTEGER(stats, PG_Reb_Stats->Parse_Memo_Misses);
 		}
 		return R_RET;
 	}
@@ -387,8 +392,8 @@ err:
 **	Args:
 **		1: codec:  handle!
 **		2: action: word! (identify, decode, encode)
-**		3: data:   binary! image! sound!
-**		4: option: (optional)
+**		3: data:   binary! image! block! map! object! string!
+**		4: /options block (optional)
 **
 ***********************************************************************/
 {
@@ -396,10 +401,16 @@ err:
 	REBVAL *val;
 	REBINT result;
 	REBSER *ser;
+	REBFLG more = FALSE;	// streaming: the input is to be continued
 
 	CLEAR(&codi, sizeof(codi));
 
 	codi.action = CODI_DECODE;
+	if (D_REF(4)) {
+		codi.opts = D_ARG(5);
+		for (val = VAL_BLK_DATA(D_ARG(5)); NOT_END(val); val++)
+			if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_MORE) more = TRUE;
+	}
 
 	val = D_ARG(3);
 
@@ -421,6 +432,8 @@ err:
 			codi.h = VAL_IMAGE_HIGH(val);
 			codi.alpha = Image_Has_Alpha(val, 0);
 		}
+		else if (!IS_BINARY(val))
+			codi.block = val; // (codec checks the type)
 		else
 			Trap1(RE_INVALID_ARG, val);
 		break;
@@ -468,6 +481,10 @@ err:
 
 	case CODI_BLOCK:
 		Set_Block(D_RET, codi.other);
+		// Remove the data that was used (the rest is to be continued).
+		// When streaming, that can be all of it:
+		if (codi.action == CODI_DECODE && ((REBCNT)codi.len < VAL_LEN(val) || more))
+			Remove_Series(VAL_SERIES(val), VAL_INDEX(val), codi.len);
 		break;
 
 	default:
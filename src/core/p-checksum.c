@@ -0,0 +1,187 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  p-checksum.c
+**  Summary: incremental checksum port
+**  Section: ports
+**  Notes:
+**    Hashes data given in pieces, so files and network streams
+**    need not be held in memory whole:
+**
+**        port: open checksum://md5  (or [scheme: 'checksum method: 'md5])
+**        write port data ...
+**        close port  read port
+**
+**    The methods are those of CHECKSUM/method (sha1, sha256,
+**    md5, crc32, crc32c). READ while open returns the result for
+**    the data so far and keeps going; after CLOSE it returns the
+**    final result.
+**
+***********************************************************************/
+
+#include "sys-core.h"
+#include "sys-digest.h"
+
+typedef struct Sum_State {
+	REBINT dig;			// index in Digests, or SUM_CRC32(C)
+	REBCNT crc;
+	REBI64 align;		// context follows, aligned
+} SUM_STATE;
+
+#define SUM_CONTEXT(s) ((void *)((s) + 1))
+#define SUM_CRC32  -1
+#define SUM_CRC32C -2
+
+
+/***********************************************************************
+**
+*/	static void Sum_Result(SUM_STATE *ss, REBVAL *out)
+/*
+**		Set the checksum of the data so far. The context is
+**		copied so that the stream can continue after.
+**
+***********************************************************************/
+{
+	REBDIG *dig;
+	REBSER *ser;
+	void *ctx;
+
+	if (ss->dig < 0) {
+		SET_INTEGER(out, (REBINT)ss->crc); // as CHECKSUM/method
+		return;
+	}
+
+	dig = &Digests[ss->dig];
+	ctx = Make_Mem(dig->ctxsize());
+	memcpy(ctx, SUM_CONTEXT(ss), dig->ctxsize());
+	ser = Make_Binary(dig->len);
+	dig->final(BIN_HEAD(ser), ctx);
+	SERIES_TAIL(ser) = dig->len;
+	Free_Mem(ctx, dig->ctxsize());
+	Set_Binary(out, ser);
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Open_Sum(REBSER *port)
+/*
+**		Returns the state binary for the method of the spec.
+**
+***********************************************************************/
+{
+	REBVAL *spec = OFV(port, STD_PORT_SPEC);
+	REBVAL *val;
+	REBCNT sym = SYM_SHA1;
+	REBSER *ser;
+	SUM_STATE *ss;
+	REBINT n;
+
+	val = Obj_Value(spec, STD_PORT_SPEC_CHECKSUM_METHOD);
+	if (IS_WORD(val)) sym = VAL_WORD_CANON(val);
+	else if (!IS_NONE(val)) Trap_Arg(val);
+
+	if (sym == SYM_CRC32) n = SUM_CRC32;
+	else if (sym == SYM_CRC32C) n = SUM_CRC32C;
+	else {
+		for (n = 0; Digests[n].digest && Digests[n].index != (REBINT)sym; n++);
+		if (!Digests[n].digest) Trap_Arg(val);
+	}
+
+	ser = Make_Binary(sizeof(SUM_STATE) + (n < 0 ? 0 : Digests[n].ctxsize()));
+	ss = (SUM_STATE *)BIN_HEAD(ser);
+	CLEAR(ss, sizeof(SUM_STATE));
+	ss->dig = n;
+	if (n >= 0) Digests[n].init(SUM_CONTEXT(ss));
+
+	return ser;
+}
+
+
+/***********************************************************************
+**
+*/	static int Checksum_Actor(REBVAL *ds, REBSER *port, REBCNT action)
+/*
+***********************************************************************/
+{
+	REBVAL *state;
+	REBVAL *arg;
+	SUM_STATE *ss = 0;
+	REBSER *ser;
+	REBCNT index;
+	REBINT len;
+
+	Validate_Port(port, action);
+
+	arg = D_ARG(2);
+	state = OFV(port, STD_PORT_STATE);
+	if (IS_BINARY(state)) ss = (SUM_STATE *)VAL_BIN(state);
+
+	switch (action) {
+
+	case A_OPEN:
+		if (ss) Trap_Port(RE_ALREADY_OPEN, port, -12);
+		SET_NONE(OFV(port, STD_PORT_DATA));
+		Set_Binary(state, Open_Sum(port));
+		break;
+
+	case A_WRITE:
+		if (!ss) Trap_Port(RE_NOT_OPEN, port, -12);
+		if (!IS_BINARY(arg) && !IS_STRING(arg)) Trap1(RE_INVALID_PORT_ARG, arg);
+		len = Partial1(arg, D_ARG(ARG_WRITE_LENGTH));
+		ser = Prep_Bin_Str(arg, &index, &len); // (UTF8 if a string)
+		if (ss->dig == SUM_CRC32) ss->crc = Update_CRC32(ss->crc, BIN_SKIP(ser, index), len);
+		else if (ss->dig == SUM_CRC32C) ss->crc = Update_CRC32C(ss->crc, BIN_SKIP(ser, index), len);
+		else Digests[ss->dig].update(SUM_CONTEXT(ss), BIN_SKIP(ser, index), len);
+		break;
+
+	case A_READ:
+		if (ss) Sum_Result(ss, D_RET);
+		else if (IS_NONE(OFV(port, STD_PORT_DATA))) Trap_Port(RE_NOT_OPEN, port, -12);
+		else *D_RET = *OFV(port, STD_PORT_DATA);
+		return R_RET;
+
+	case A_CLOSE:
+		if (ss) {
+			Sum_Result(ss, OFV(port, STD_PORT_DATA)); // for READ after
+			SET_NONE(state);
+		}
+		break;
+
+	case A_OPENQ:
+		return ss ? R_TRUE : R_FALSE;
+
+	default:
+		Trap_Action(REB_PORT, action);
+	}
+
+	return R_ARG1; // port
+}
+
+
+/***********************************************************************
+**
+*/	void Init_Checksum_Scheme(void)
+/*
+***********************************************************************/
+{
+	Register_Scheme(SYM_CHECKSUM, 0, Checksum_Actor);
+}
@@ -0,0 +1,471 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  p-compress.c
+**  Summary: streaming compress and decompress ports
+**  Section: ports
+**  Notes:
+**    Data is fed in pieces with WRITE and the result so far is
+**    taken with READ, so memory use is bounded by what the caller
+**    has not yet read (plus the zlib window):
+**
+**        port: open [scheme: 'compress level: 9 format: 'gzip]
+**        write port data ...  append file read port ...
+**        close port           append file read port
+**
+**    Formats are zlib (the default), gzip and deflate (raw, no
+**    header). A decompress port given no format detects gzip or
+**    zlib from the first byte. UPDATE on a compress port flushes
+**    the output so far to a byte boundary (for network streams).
+**    CLOSE ends the stream: for compress it writes the final
+**    block (and gzip trailer), so READ must follow it; for
+**    decompress it checks that the stream was complete.
+**
+**    The zlib state is outside of REBOL memory (port/state is a
+**    handle! to it). CLOSE frees it, or else the GC does when the
+**    port is collected.
+**
+***********************************************************************/
+
+#include "sys-core.h"
+#include "sys-zlib.h"
+#include "sys-digest.h"
+
+#define ZIP_CHUNK	32768	// output buffer growth
+
+enum {
+	ZIP_AUTO,		// decompress: decide from first byte
+	ZIP_ZLIB,
+	ZIP_GZIP,
+	ZIP_RAW,
+};
+
+enum {				// stream progress
+	GZ_FIXED,		// gzip header: fixed ten bytes
+	GZ_XLEN,		// extra field length
+	GZ_EXTRA,		// extra field
+	GZ_NAME,		// file name
+	GZ_COMMENT,		// comment
+	GZ_HCRC,		// header CRC
+	GZ_BODY,		// compressed data
+	GZ_TRAILER,		// gzip trailer: CRC and size
+	GZ_DONE,
+};
+
+// Gzip header flags:
+#define GZF_HCRC	0x02
+#define GZF_EXTRA	0x04
+#define GZF_NAME	0x08
+#define GZF_COMMENT	0x10
+
+typedef struct Zip_State {
+	z_stream strm;
+	REBFLG inflate;		// decompressing
+	REBINT format;
+	REBINT level;
+	REBINT stage;
+	REBCNT count;		// bytes of the stage so far
+	REBCNT need;		// gzip extra field bytes left
+	REBCNT flags;		// gzip header flags not yet handled
+	REBCNT crc;			// gzip CRC of uncompressed data
+	REBCNT size;		// gzip size of uncompressed data
+	REBYTE trailer[8];
+} ZIP_STATE;
+
+
+/***********************************************************************
+**
+*/	static void Trap_Zip(REBINT err)
+/*
+***********************************************************************/
+{
+	if (err == Z_MEM_ERROR) Trap0(RE_NO_MEMORY);
+	DS_PUSH_INTEGER(err);
+	Trap1(RE_BAD_PRESS, DS_TOP);
+}
+
+
+/***********************************************************************
+**
+*/	static void Init_Zip(ZIP_STATE *zs)
+/*
+**		Start the zlib stream (once the format is known).
+**
+***********************************************************************/
+{
+	REBINT wbits = (zs->format == ZIP_ZLIB) ? MAX_WBITS : -MAX_WBITS;
+	REBINT err;
+
+	zs->strm.checksum = adler32;
+	zs->stage = (zs->format == ZIP_GZIP) ? GZ_FIXED : GZ_BODY;
+	if (zs->inflate)
+		err = inflateInit2(&zs->strm, wbits);
+	else {
+		err = deflateInit2(&zs->strm, zs->level, Z_DEFLATED, wbits, 8, Z_DEFAULT_STRATEGY);
+		zs->stage = GZ_BODY;
+	}
+	if (err != Z_OK) {
+		zs->format = ZIP_AUTO; // not started
+		Trap_Zip(err);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static REBINT Run_Zip(ZIP_STATE *zs, REBSER *out, REBYTE *bp, REBCNT len, REBINT flush)
+/*
+**		Feed input to the stream, appending all output produced.
+**		Stops at the end of the compressed stream when inflating.
+**		Returns a zlib error code, or zero.
+**
+***********************************************************************/
+{
+	z_stream *z = &zs->strm;
+	REBCNT tail;
+	REBCNT n;
+	REBINT err;
+
+	z->next_in = bp;
+	z->avail_in = len;
+
+	do {
+		if (SERIES_AVAIL(out) < ZIP_CHUNK) Extend_Series(out, ZIP_CHUNK);
+		tail = SERIES_TAIL(out);
+		z->next_out = BIN_SKIP(out, tail);
+		z->avail_out = SERIES_AVAIL(out);
+
+		err = zs->inflate ? inflate(z, flush) : deflate(z, flush);
+
+		n = z->next_out - BIN_SKIP(out, tail);
+		SERIES_TAIL(out) = tail + n;
+		if (zs->inflate && zs->format == ZIP_GZIP) {
+			zs->crc = Update_CRC32(zs->crc, BIN_SKIP(out, tail), n);
+			zs->size += n;
+		}
+
+		if (err == Z_STREAM_END) {
+			zs->stage = (zs->format == ZIP_GZIP && zs->inflate) ? GZ_TRAILER : GZ_DONE;
+			break;
+		}
+		if (err == Z_BUF_ERROR) break; // no progress was possible
+		if (err != Z_OK) break;
+	} while (z->avail_in > 0 || z->avail_out == 0);
+
+	STR_TERM(out);
+	return (err == Z_OK || err == Z_STREAM_END || err == Z_BUF_ERROR) ? 0 : err;
+}
+
+
+/***********************************************************************
+**
+*/	static void Skip_Gzip_Header(ZIP_STATE *zs, REBYTE **bpp, REBCNT *lenp)
+/*
+**		Consume gzip header bytes, which may arrive in any pieces.
+**
+***********************************************************************/
+{
+	REBYTE *bp = *bpp;
+	REBCNT len = *lenp;
+	REBYTE c;
+
+	for (; len > 0 && zs->stage < GZ_BODY; bp++, len--) {
+		c = *bp;
+		switch (zs->stage) {
+		case GZ_FIXED:
+			if ((zs->count == 0 && c != 0x1F) || (zs->count == 1 && c != 0x8B)
+				|| (zs->count == 2 && c != Z_DEFLATED)) Trap_Zip(Z_DATA_ERROR);
+			if (zs->count == 3) zs->flags = c & (GZF_HCRC | GZF_EXTRA | GZF_NAME | GZF_COMMENT);
+			if (++zs->count < 10) continue;
+			break;
+		case GZ_XLEN:
+			zs->need = zs->count ? zs->need | (REBCNT)c << 8 : c;
+			if (++zs->count < 2) continue;
+			zs->flags &= ~GZF_EXTRA;
+			if (zs->need) {
+				zs->stage = GZ_EXTRA;
+				continue;
+			}
+			break;
+		case GZ_EXTRA:
+			if (--zs->need) continue;
+			break;
+		case GZ_NAME:
+			if (c) continue;
+			zs->flags &= ~GZF_NAME;
+			break;
+		case GZ_COMMENT:
+			if (c) continue;
+			zs->flags &= ~GZF_COMMENT;
+			break;
+		case GZ_HCRC:
+			if (++zs->count < 2) continue;
+			zs->flags &= ~GZF_HCRC;
+			break;
+		}
+		// This part is done, so go to the next one (in header order):
+		zs->count = 0;
+		if (zs->flags & GZF_EXTRA) zs->stage = GZ_XLEN;
+		else if (zs->flags & GZF_NAME) zs->stage = GZ_NAME;
+		else if (zs->flags & GZF_COMMENT) zs->stage = GZ_COMMENT;
+		else if (zs->flags & GZF_HCRC) zs->stage = GZ_HCRC;
+		else zs->stage = GZ_BODY;
+	}
+
+	*bpp = bp;
+	*lenp = len;
+}
+
+
+/***********************************************************************
+**
+*/	static void Write_Zip(ZIP_STATE *zs, REBSER *out, REBYTE *bp, REBCNT len)
+/*
+***********************************************************************/
+{
+	REBCNT n;
+	REBINT err;
+
+	if (!zs->inflate) {
+		if (zs->format == ZIP_GZIP) {
+			zs->crc = Update_CRC32(zs->crc, bp, len);
+			zs->size += len;
+		}
+		if (NZ(err = Run_Zip(zs, out, bp, len, Z_NO_FLUSH))) Trap_Zip(err);
+		return;
+	}
+
+	if (zs->format == ZIP_AUTO) {
+		if (!len) return;
+		zs->format = (*bp == 0x1F) ? ZIP_GZIP : ZIP_ZLIB;
+		Init_Zip(zs);
+	}
+
+	if (zs->stage < GZ_BODY) Skip_Gzip_Header(zs, &bp, &len);
+
+	if (zs->stage == GZ_BODY && len > 0) {
+		if (NZ(err = Run_Zip(zs, out, bp, len, Z_NO_FLUSH))) Trap_Zip(err);
+		bp = zs->strm.next_in;
+		len = zs->strm.avail_in;
+	}
+
+	if (zs->stage == GZ_TRAILER && len > 0) {
+		n = MIN(len, 8 - zs->count);
+		memcpy(zs->trailer + zs->count, bp, n);
+		zs->count += n;
+		if (zs->count == 8) {
+			if (zs->crc != Bytes_To_Long(zs->trailer)
+				|| zs->size != Bytes_To_Long(zs->trailer + 4)) Trap_Zip(Z_DATA_ERROR);
+			zs->stage = GZ_DONE;
+		}
+	}
+	// Data after the end of the stream is ignored.
+}
+
+
+/***********************************************************************
+**
+*/	static REBINT End_Zip(ZIP_STATE *zs, REBSER *out)
+/*
+**		Finish the compressed stream, or check that the
+**		decompressed one was complete. Returns a zlib error
+**		code, or zero.
+**
+***********************************************************************/
+{
+	REBYTE pad = 0;
+	REBINT err;
+
+	if (zs->format == ZIP_AUTO) return 0; // never started
+
+	if (!zs->inflate) {
+		if (NZ(err = Run_Zip(zs, out, 0, 0, Z_FINISH))) return err;
+		if (zs->stage != GZ_DONE) return Z_BUF_ERROR;
+		if (zs->format == ZIP_GZIP) {
+			Long_To_Bytes(zs->trailer, zs->crc);
+			Long_To_Bytes(zs->trailer + 4, zs->size);
+			Append_Series(out, zs->trailer, 8);
+		}
+		return 0;
+	}
+
+	// A raw stream may need a byte past its end to finish:
+	if (zs->format == ZIP_RAW && zs->stage == GZ_BODY
+		&& NZ(err = Run_Zip(zs, out, &pad, 1, Z_FINISH))) return err;
+
+	return (zs->stage == GZ_DONE) ? 0 : Z_BUF_ERROR; // (data is cut short)
+}
+
+
+/***********************************************************************
+**
+*/	static void Open_Zip(REBSER *port, ZIP_STATE *zs)
+/*
+***********************************************************************/
+{
+	REBVAL *spec = OFV(port, STD_PORT_SPEC);
+	REBVAL *val;
+	REBSER *out;
+
+	zs->inflate = (VAL_WORD_CANON(Obj_Value(spec, STD_PORT_SPEC_ZIP_SCHEME)) == SYM_DECOMPRESS);
+
+	val = Obj_Value(spec, STD_PORT_SPEC_ZIP_LEVEL);
+	zs->level = Z_DEFAULT_COMPRESSION;
+	if (IS_INTEGER(val)) {
+		if (VAL_INT64(val) < 0 || VAL_INT64(val) > 9) Trap_Arg(val);
+		zs->level = VAL_INT32(val);
+	}
+	else if (!IS_NONE(val)) Trap_Arg(val);
+
+	val = Obj_Value(spec, STD_PORT_SPEC_ZIP_FORMAT);
+	if (IS_NONE(val)) zs->format = zs->inflate ? ZIP_AUTO : ZIP_ZLIB;
+	else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_ZLIB) zs->format = ZIP_ZLIB;
+	else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_GZIP) zs->format = ZIP_GZIP;
+	else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_DEFLATE) zs->format = ZIP_RAW;
+	else Trap_Arg(val);
+
+	out = Make_Binary(ZIP_CHUNK);
+	Set_Binary(OFV(port, STD_PORT_DATA), out);
+
+	if (zs->format == ZIP_AUTO) return; // starts with the first data
+
+	Init_Zip(zs);
+
+	if (zs->format == ZIP_GZIP && !zs->inflate) {
+		// Header: magic, deflate, no flags or time, unknown OS:
+		static const REBYTE gz_head[10] = {0x1F, 0x8B, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xFF};
+		Append_Series(out, (REBYTE *)gz_head, 10);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void Final_Zip(void *data)
+/*
+**		Free the zlib stream and its state (also called by the GC
+**		when a port was not closed).
+**
+***********************************************************************/
+{
+	ZIP_STATE *zs = (ZIP_STATE *)data;
+
+	if (zs->format != ZIP_AUTO) {
+		if (zs->inflate) inflateEnd(&zs->strm);
+		else deflateEnd(&zs->strm);
+	}
+	Free_Mem(zs, sizeof(ZIP_STATE));
+}
+
+
+/***********************************************************************
+**
+*/	static void Free_Zip(REBSER *port, ZIP_STATE *zs)
+/*
+***********************************************************************/
+{
+	Loose_Final(zs);
+	Final_Zip(zs);
+	SET_NONE(OFV(port, STD_PORT_STATE));
+}
+
+
+/***********************************************************************
+**
+*/	static int Zip_Actor(REBVAL *ds, REBSER *port, REBCNT action)
+/*
+***********************************************************************/
+{
+	REBVAL *state;
+	REBVAL *arg;
+	REBVAL *data;
+	ZIP_STATE *zs = 0;
+	REBSER *ser;
+	REBCNT index;
+	REBINT len;
+
+	Validate_Port(port, action);
+
+	arg = D_ARG(2);
+	state = OFV(port, STD_PORT_STATE);
+	data = OFV(port, STD_PORT_DATA);
+	zs = (ZIP_STATE *)Find_Final(port); // (not from the state, which code can change)
+
+	switch (action) {
+
+	case A_OPEN:
+		if (zs) Trap_Port(RE_ALREADY_OPEN, port, -12);
+		// zlib points back into its stream, so it must not move:
+		if (!(zs = Make_Mem(sizeof(ZIP_STATE)))) Trap0(RE_NO_MEMORY);
+		Guard_Final(port, zs, Final_Zip);
+		SET_HANDLE(state, zs);
+		Open_Zip(port, zs);
+		break;
+
+	case A_WRITE:
+		if (!zs) Trap_Port(RE_NOT_OPEN, port, -12);
+		if (!IS_BINARY(arg) && !IS_STRING(arg)) Trap1(RE_INVALID_PORT_ARG, arg);
+		len = Partial1(arg, D_ARG(ARG_WRITE_LENGTH));
+		ser = Prep_Bin_Str(arg, &index, &len); // (UTF8 if a string)
+		Write_Zip(zs, VAL_SERIES(data), BIN_SKIP(ser, index), len);
+		break;
+
+	case A_READ:
+		// Take the output so far (also allowed after the close):
+		if (!IS_BINARY(data)) Trap_Port(RE_NOT_OPEN, port, -12);
+		*D_RET = *data;
+		Set_Binary(data, Make_Binary(zs ? ZIP_CHUNK : 0));
+		return R_RET;
+
+	case A_UPDATE:
+		if (zs && !zs->inflate && zs->stage == GZ_BODY
+			&& NZ(len = Run_Zip(zs, VAL_SERIES(data), 0, 0, Z_SYNC_FLUSH))) Trap_Zip(len);
+		break;
+
+	case A_CLOSE:
+		if (zs) {
+			// The stream is freed even if its end is in error:
+			len = End_Zip(zs, VAL_SERIES(data));
+			Free_Zip(port, zs);
+			if (len) Trap_Zip(len);
+		}
+		break;
+
+	case A_OPENQ:
+		return zs ? R_TRUE : R_FALSE;
+
+	default:
+		Trap_Action(REB_PORT, action);
+	}
+
+	return R_ARG1; // port
+}
+
+
+/***********************************************************************
+**
+*/	void Init_Compress_Scheme(void)
+/*
+***********************************************************************/
+{
+	Register_Scheme(SYM_COMPRESS, 0, Zip_Actor);
+	Register_Scheme(SYM_DECOMPRESS, 0, Zip_Actor);
+}
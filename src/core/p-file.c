@@ -28,12 +28,16 @@
 ***********************************************************************/
 
 #include "sys-core.h"
+#include "reb-evtypes.h"
 
 // For reference to port/state series that holds the file structure:
 #define AS_FILE(s) ((REBREQ*)VAL_BIN(s))
 #define READ_MAX ((REBCNT)(-1))
 #define HL64(v) (v##l + (v##h << 32))
 #define MAX_READ_MASK 0x7FFFFFFF // max size per chunk
+#define MIN_MAP_SIZE 0x100000 // smaller files are read, not mapped
+#define LINE_BUF_SIZE 0x10000 // chunk size for streaming READ/LINES
+#define WRITE_BUF_SIZE 0x8000 // chunk size for encoded WRITE
 
 
 /***********************************************************************
@@ -187,24 +191,43 @@ REBINT Mode_Syms[] = {
 **
 ***********************************************************************/
 {
-	REBSER *ser;
+	REBSER *ser = 0;
 	REBVAL *ds = DS_RETURN;
+	REBYTE *bp;
+
+	// Large whole file reads are mapped into memory, not copied.
+	// The device clears RFM_MAP if it cannot map this file.
+	if (len >= MIN_MAP_SIZE && file->file.index == 0) {
+		SET_FLAG(file->modes, RFM_MAP);
+		file->length = len;
+		if (OS_DO_DEVICE(file, RDC_READ) < 0) Trap_Port(RE_READ_ERROR, port, file->error);
+		if (GET_FLAG(file->modes, RFM_MAP)) {
+			CLR_FLAG(file->modes, RFM_MAP);
+			ser = Make_Mapped_Binary(file->data, file->actual);
+		}
+	}
 
-	// Allocate read result buffer:
-	ser = Make_Binary(len);
-	Set_Series(REB_BINARY, ds, ser); //??? what if already set?
+	if (!ser) {
+		// Allocate read result buffer:
+		ser = Make_Binary(len);
 
-	// Do the read, check for errors:
-	file->data = BIN_HEAD(ser);
-	file->length = len;
-	if (OS_DO_DEVICE(file, RDC_READ) < 0) Trap_Port(RE_READ_ERROR, port, file->error);
-	SERIES_TAIL(ser) = file->actual;
+		// Do the read, check for errors:
+		file->data = BIN_HEAD(ser);
+		file->length = len;
+		if (OS_DO_DEVICE(file, RDC_READ) < 0) Trap_Port(RE_READ_ERROR, port, file->error);
+		SERIES_TAIL(ser) = file->actual;
+	}
 	STR_TERM(ser);
+	Set_Series(REB_BINARY, ds, ser); //??? what if already set?
 
 	// Convert to string or block of strings.
 	// NOTE: This code is incorrect for files read in chunks!!!
 	if (args & (AM_READ_STRING | AM_READ_LINES)) {
-		ser = Decode_UTF_String(BIN_HEAD(ser), file->actual, -1);
+		// Plain ASCII text without CR needs no decoding, so the
+		// binary (mapped or not) becomes the string as it is:
+		bp = BIN_HEAD(ser);
+		if (What_UTF(bp, file->actual) || Is_Not_ASCII(bp, file->actual) || memchr(bp, CR, file->actual))
+			ser = Decode_UTF_String(bp, file->actual, -1);
 		Set_String(ds, ser);
 		if (args & AM_READ_LINES) Set_Block(ds, Split_Lines(ds));
 	}
@@ -213,37 +236,285 @@ REBINT Mode_Syms[] = {
 
 /***********************************************************************
 **
-*/	static void Write_File_Port(REBREQ *file, REBVAL *data, REBCNT len, REBCNT args)
+*/	static void Append_Line(REBSER *blk, REBYTE *bp, REBCNT len)
 /*
+**		Decode a UTF-8 line (without its LF) and append it to
+**		the block. A CR before the LF is removed.
+**
 ***********************************************************************/
 {
+	REBVAL *val;
+
+	if (len > 0 && bp[len-1] == CR) len--;
+	val = Append_Value(blk);
+	Set_String(val, Decode_UTF_String(bp, len, 0));
+	VAL_SET_LINE(val);
+}
+
+
+/***********************************************************************
+**
+*/	static void Read_Lines_Port(REBSER *port, REBREQ *file, REBCNT max)
+/*
+**		Read the next lines from an open file port, in fixed size
+**		chunks, so that files of any size use constant memory.
+**		Returns a block of up to max lines, or NONE at the end
+**		(an empty block for max of zero).
+**
+**		Only whole lines are decoded. The unfinished line at the
+**		end of a chunk is held in port/data for the next read.
+**		Lines end with LF (CR-LF is also removed). An LF byte never
+**		occurs within a UTF-8 sequence, so chars are never split.
+**
+***********************************************************************/
+{
+	REBVAL *ds = DS_RETURN;
+	REBVAL *buf = BLK_SKIP(port, STD_PORT_DATA);
 	REBSER *ser;
+	REBSER *blk;
+	REBYTE *bp;
+	REBCNT start;
+	REBCNT tail;
+	REBCNT n;
+	REBOOL eof = FALSE;
+
+	if (!IS_BINARY(buf)) Set_Binary(buf, Make_Binary(LINE_BUF_SIZE));
+	ser = VAL_SERIES(buf);
+
+	blk = Make_Block(max < 64 ? max : 64);
+	Set_Block(ds, blk);
+
+	while (TRUE) {
+		// Take the whole lines now in the buffer:
+		bp = BIN_HEAD(ser);
+		tail = SERIES_TAIL(ser);
+		for (start = n = VAL_INDEX(buf); n < tail && SERIES_TAIL(blk) < max; n++) {
+			if (bp[n] == LF) {
+				Append_Line(blk, bp + start, n - start);
+				start = n + 1;
+			}
+		}
+		// At the end of the file, the rest is the last line:
+		if (eof && start < tail && SERIES_TAIL(blk) < max) {
+			Append_Line(blk, bp + start, tail - start);
+			start = tail;
+		}
+		VAL_INDEX(buf) = start;
+
+		if (eof || SERIES_TAIL(blk) >= max) break;
+		if (SERIES_TAIL(blk) > 0 && max == READ_MAX) break; // one chunk
+
+		// Drop the used bytes, then append the next chunk:
+		Remove_Series(ser, 0, start);
+		VAL_INDEX(buf) = 0;
+		tail = SERIES_TAIL(ser);
+		EXPAND_SERIES_TAIL(ser, LINE_BUF_SIZE);
+		file->data = BIN_SKIP(ser, tail);
+		file->length = LINE_BUF_SIZE;
+		if (OS_DO_DEVICE(file, RDC_READ) < 0) Trap_Port(RE_READ_ERROR, port, file->error);
+		SERIES_TAIL(ser) = tail + file->actual;
+
+		// Skip the UTF-8 BOM at the start of the file (lines are
+		// split on LF bytes, so other encodings are not allowed):
+		if (file->file.index == file->actual && (n = What_UTF(BIN_HEAD(ser), SERIES_TAIL(ser)))) {
+			if (n != 8) Trap0(RE_BAD_DECODE);
+			Remove_Series(ser, 0, 3);
+		}
+		if (file->actual == 0) eof = TRUE;
+	}
 
-	if (IS_BLOCK(data)) {
-		// Form the values of the block
-		// !! Could be made more efficient if we broke the FORM
-		// into 32K chunks for writing.
-		REB_MOLD mo = {0};
-		Reset_Mold(&mo);
+	if (SERIES_TAIL(blk) == 0 && max > 0) SET_NONE(ds);
+}
+
+
+/***********************************************************************
+**
+*/	static void Drop_Line_Buffer(REBSER *port, REBREQ *file)
+/*
+**		Bytes read ahead by READ/lines are held in port/data. Move
+**		the file position back to the first of them and drop the
+**		buffer, so that other actions see the file where the lines
+**		left off.
+**
+***********************************************************************/
+{
+	REBVAL *buf = BLK_SKIP(port, STD_PORT_DATA);
+
+	if (!IS_OPEN(file) || GET_FLAG(file->modes, RFM_ASYNC) || !IS_BINARY(buf)) return;
+
+	file->file.index -= VAL_LEN(buf);
+	SET_FLAG(file->modes, RFM_RESEEK);
+	SET_NONE(buf);
+}
+
+
+/***********************************************************************
+**
+*/	static void Write_Chars(REBREQ *file, void *src, REBCNT len, REBFLG uni)
+/*
+**		Encode chars (bytes or Unicode) as UTF-8 and write them in
+**		chunks through the shared form buffer, so a large string
+**		needs no encoded copy of its full size. ASCII bytes need
+**		no encoding and are written directly.
+**
+***********************************************************************/
+{
+	REBYTE *bp = (REBYTE*)src;
+	REBUNI *up = (REBUNI*)src;
+	REBYTE *buf;
+	REBCNT size;
+	REBCNT n;
+
+	if (!uni && !Is_Not_ASCII(bp, len)) {
+		file->data = bp;
+		file->length = len;
+		OS_DO_DEVICE(file, RDC_WRITE);
+		return;
+	}
+
+	buf = Reset_Buffer(BUF_FORM, WRITE_BUF_SIZE);
+	while (len > 0) {
+		size = len; // chars in, bytes out
+		n = Encode_UTF8(buf, WRITE_BUF_SIZE, uni ? (void*)up : (void*)bp, &size, uni, ENCF_OS_CRLF != 0);
+		if (uni) up += n; else bp += n;
+		len -= n;
+		file->data = buf;
+		file->length = size;
+		if (OS_DO_DEVICE(file, RDC_WRITE) < 0) return;
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void Write_Block_Port(REBREQ *file, REBVAL *block, REBCNT args)
+/*
+**		Form the values of a block and write them. The formed text
+**		is written each time it reaches the chunk size, so memory
+**		use is bounded by the chunk (and the largest value), not
+**		by the size of the block. Spacing follows FORM of a block.
+**
+***********************************************************************/
+{
+	REB_MOLD mo = {0};
+	REBSER *blk = VAL_SERIES(block);
+	REBCNT tail = SERIES_TAIL(blk);
+	REBCNT n;
+	REBUNI last = 0; // last char formed, kept across chunks
+
+	if (args & AM_WRITE_LINES) {
+		mo.opts = 1 << MOPT_LINES;
+	}
+	Reset_Mold(&mo);
+
+	for (n = VAL_INDEX(block); n < tail; n++) {
+		Mold_Value(&mo, BLK_SKIP(blk, n), 0);
 		if (args & AM_WRITE_LINES) {
-			mo.opts = 1 << MOPT_LINES;
+			Append_Byte(mo.series, LF);
+		}
+		else if (n + 1 < tail) {
+			// Add a space if needed:
+			if (SERIES_TAIL(mo.series)) last = *UNI_LAST(mo.series);
+			if (last && last != LF) Append_Byte(mo.series, ' ');
+		}
+
+		if (SERIES_TAIL(mo.series) >= WRITE_BUF_SIZE) {
+			last = *UNI_LAST(mo.series);
+			Write_Chars(file, UNI_HEAD(mo.series), SERIES_TAIL(mo.series), TRUE);
+			if (file->error) return;
+			Reset_Mold(&mo);
 		}
-		Mold_Value(&mo, data, 0);
-		Set_String(data, mo.series); // fall into next section
-		len = SERIES_TAIL(mo.series);
 	}
 
-	// Auto convert string to UTF-8
-	if (IS_STRING(data)) {
-		ser = Encode_UTF8_Value(data, len, ENCF_OS_CRLF);
-		file->data = ser? BIN_HEAD(ser) : VAL_BIN_DATA(data); // No encoding may be needed
-		len = SERIES_TAIL(ser);
+	Write_Chars(file, UNI_HEAD(mo.series), SERIES_TAIL(mo.series), TRUE);
+}
+
+
+/***********************************************************************
+**
+*/	static void Write_File_Port(REBREQ *file, REBVAL *data, REBCNT len, REBCNT args)
+/*
+***********************************************************************/
+{
+	if (IS_BLOCK(data)) {
+		Write_Block_Port(file, data, args);
+	}
+	else if (IS_STRING(data)) {
+		// Auto convert string to UTF-8
+		if (VAL_BYTE_SIZE(data)) Write_Chars(file, VAL_BIN_DATA(data), len, FALSE);
+		else Write_Chars(file, VAL_UNI_DATA(data), len, TRUE);
 	}
 	else {
 		file->data = VAL_BIN_DATA(data);
+		file->length = len;
+		OS_DO_DEVICE(file, RDC_WRITE);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void Hold_File_Job(REBSER *port, REBFLG hold)
+/*
+**		The device works on the request inside the port's state
+**		series, and on the data series, while the program runs on.
+**		Keep the port and both series from the GC (even if the
+**		port fields are changed) until the result is taken by
+**		A_UPDATE, or the port is closed.
+**
+***********************************************************************/
+{
+	REBSER *jobs = VAL_SERIES(ROOT_FILE_JOBS);
+	REBVAL *val;
+	REBCNT n;
+
+	if (hold) {
+		val = Append_Value(jobs);
+		SET_PORT(val, port);
+		*Append_Value(jobs) = *BLK_SKIP(port, STD_PORT_STATE);
+		*Append_Value(jobs) = *BLK_SKIP(port, STD_PORT_DATA);
+		return;
+	}
+
+	for (n = 0; n < SERIES_TAIL(jobs); n += 3) {
+		if (VAL_PORT(BLK_SKIP(jobs, n)) == port) {
+			Remove_Series(jobs, n, 3);
+			return;
+		}
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void Start_Async_File(REBSER *port, REBREQ *file, REBCNT command)
+/*
+**		Start a READ or WRITE on a port that has an awake function.
+**		The data is kept in port/data. When the request is done,
+**		the port gets a READ or WROTE event and A_UPDATE sets the
+**		result. If the device did the request at once (it has no
+**		workers, or they are all busy), the event is sent here.
+**
+***********************************************************************/
+{
+	REBVAL *event;
+	REBINT result;
+
+	Hold_File_Job(port, TRUE);
+	result = OS_DO_DEVICE(file, command);
+	if (result < 0) {
+		Hold_File_Job(port, FALSE);
+		SET_NONE(BLK_SKIP(port, STD_PORT_DATA));
+		Trap_Port(command == RDC_READ ? RE_READ_ERROR : RE_WRITE_ERROR, port, file->error);
+	}
+
+	if (result == DR_DONE && NZ(event = Append_Event())) {
+		VAL_SET(event, REB_EVENT);
+		VAL_EVENT_TYPE(event) = (command == RDC_READ) ? EVT_READ : EVT_WROTE;
+		VAL_EVENT_FLAGS(event) = 0;
+		VAL_EVENT_MODEL(event) = EVM_DEVICE;
+		VAL_EVENT_REQ(event) = file;
 	}
-	file->length = len;
-	OS_DO_DEVICE(file, RDC_WRITE);
 }
 
 
@@ -332,6 +603,15 @@ REBINT Mode_Syms[] = {
 	// Get or setup internal state data:
 	file = (REBREQ*)Use_Port_State(port, RDI_FILE, sizeof(*file));
 
+	// A worker thread owns the request until its event is handled:
+	if (
+		GET_FLAG(file->flags, RRF_PENDING)
+		&& action != A_UPDATE && action != A_CLOSE && action != A_OPENQ
+	) Trap1(RE_PORT_BUSY, path);
+
+	// Only READ/lines continues from its read-ahead bytes:
+	if (action != A_READ) Drop_Line_Buffer(port, file);
+
 	switch (action) {
 
 	case A_READ:
@@ -346,7 +626,31 @@ REBINT Mode_Syms[] = {
 			opened = TRUE;
 		}
 
-		if (args & AM_READ_SEEK) Set_Seek(file, D_ARG(ARG_READ_INDEX));
+		if (args & AM_READ_SEEK) {
+			Set_Seek(file, D_ARG(ARG_READ_INDEX));
+			SET_NONE(BLK_SKIP(port, STD_PORT_DATA)); // drop line buffer
+		}
+
+		// Ports with an awake function read in the background:
+		if (GET_FLAG(file->modes, RFM_ASYNC)) {
+			spec = BLK_SKIP(port, STD_PORT_DATA);
+			len = Set_Length(ds, file, ARG_READ_PART);
+			Set_Binary(spec, Make_Binary(len));
+			file->data = VAL_BIN(spec);
+			file->length = len;
+			file->actual = 0;
+			Start_Async_File(port, file, RDC_READ);
+			break;
+		}
+
+		// Stream lines from an open port (/part is a line count):
+		if (!opened && (args & AM_READ_LINES)) {
+			len = (args & AM_READ_PART) ? Int32s(D_ARG(ARG_READ_LENGTH), 0) : READ_MAX;
+			Read_Lines_Port(port, file, len);
+			break;
+		}
+
+		Drop_Line_Buffer(port, file);
 		len = Set_Length(ds, file, ARG_READ_PART);
 		Read_File_Port(port, file, path, args, len);
 
@@ -394,6 +698,25 @@ REBINT Mode_Syms[] = {
 			if (n <= len) len = n;
 		}
 
+		// Ports with an awake function write in the background:
+		if (GET_FLAG(file->modes, RFM_ASYNC) && !opened) {
+			REBVAL *data = BLK_SKIP(port, STD_PORT_DATA); // keeps it GC safe
+			if (IS_BLOCK(spec)) {
+				Set_String(spec, Copy_Form_Value(spec, (args & AM_WRITE_LINES) ? 1 << MOPT_LINES : 0));
+				len = VAL_LEN(spec);
+			}
+			if (IS_STRING(spec)) {
+				Set_Binary(data, Encode_UTF8_Value(spec, len, ENCF_OS_CRLF));
+				len = VAL_LEN(data);
+			}
+			else *data = *spec;
+			file->data = VAL_BIN_DATA(data);
+			file->length = len;
+			file->actual = 0;
+			Start_Async_File(port, file, RDC_WRITE);
+			break;
+		}
+
 		Write_File_Port(file, spec, len, args);
 
 		if (opened) {
@@ -411,6 +734,7 @@ REBINT Mode_Syms[] = {
 		if (!(args & (AM_OPEN_READ | AM_OPEN_WRITE))) args |= (AM_OPEN_READ | AM_OPEN_WRITE);
 		Setup_File(file, args, path);
 		Open_File_Port(port, file, path); // !!! needs to change file modes to R/O if necessary
+		if (ANY_FUNC(BLK_SKIP(port, STD_PORT_AWAKE))) SET_FLAG(file->modes, RFM_ASYNC);
 		break;
 
 	case A_COPY:
@@ -419,16 +743,34 @@ REBINT Mode_Syms[] = {
 		Read_File_Port(port, file, path, args, len);
 		break;
 
+	case A_UPDATE:
+		// Update the port object after an async READ or WRITE.
+		// This is normally called by the WAKE-UP function.
+		Hold_File_Job(port, FALSE);
+		spec = BLK_SKIP(port, STD_PORT_DATA);
+		if (file->command == RDC_READ) {
+			if (IS_BINARY(spec) && !file->error) {
+				SERIES_TAIL(VAL_SERIES(spec)) = file->actual;
+				STR_TERM(VAL_SERIES(spec));
+			}
+		}
+		else if (file->command == RDC_WRITE) {
+			SET_NONE(spec);  // Write is done.
+		}
+		return R_NONE;
+
 	case A_OPENQ:
 		if (IS_OPEN(file)) return R_TRUE;
 		return R_FALSE;
 
 	case A_CLOSE:
 		if (IS_OPEN(file)) {
-			OS_DO_DEVICE(file, RDC_CLOSE);
+			OS_DO_DEVICE(file, RDC_CLOSE); // (waits for a pending request)
 			Cleanup_File(file);
 			Free_Port_State(port);
 		}
+		Hold_File_Job(port, FALSE);
+		SET_NONE(BLK_SKIP(port, STD_PORT_DATA)); // drop line buffer
 		break;
 
 	case A_DELETE:
@@ -550,6 +892,7 @@ REBINT Mode_Syms[] = {
 
 seeked:
 	SET_FLAG(file->modes, RFM_RESEEK);
+	SET_NONE(BLK_SKIP(port, STD_PORT_DATA)); // drop line buffer
 	return R_ARG1;
 
 is_true:
@@ -571,6 +914,7 @@ is_false:
 ***********************************************************************/
 {
 	Register_Scheme(SYM_FILE, 0, File_Actor);
+	Set_Root_Series(ROOT_FILE_JOBS, Make_Block(12), "file jobs");
 }
 
 
@@ -34,6 +34,11 @@
 
 #define NET_BUF_SIZE 32*1024
 
+enum Transport_Types {
+	TRANSPORT_TCP,
+	TRANSPORT_UDP
+};
+
 /***********************************************************************
 **
 */	static void Ret_Query_Net(REBSER *port, REBREQ *sock, REBVAL *ret)
@@ -89,8 +94,81 @@
 
 /***********************************************************************
 **
-*/	static int TCP_Actor(REBVAL *ds, REBSER *port, REBCNT action)
+*/	static REBSER *Pack_Datagrams(REBREQ *sock, REBVAL *blk)
+/*
+**		Pack a block of binary (or string) values into a batch
+**		buffer of REBDGM records, one datagram per value. Strings
+**		are sent UTF-8 encoded. All of them are addressed to the
+**		current remote IP and port.
+**
+***********************************************************************/
+{
+	REBSER *ser;
+	REBVAL *val;
+	REBDGM *dg;
+	REBCNT len = 0;
+	REBCNT n;
+
+	for (val = VAL_BLK_DATA(blk); NOT_END(val); val++) {
+		if (IS_BINARY(val)) n = VAL_LEN(val);
+		else if (IS_STRING(val)) n = Length_As_UTF8((REBUNI *)VAL_DATA(val), VAL_LEN(val), (REBOOL)!VAL_BYTE_SIZE(val), 0);
+		else Trap_Arg(val);
+		if (n > DGRAM_MAX) Trap_Range(val);
+		len += sizeof(REBDGM) + DGRAM_ALIGN(n);
+	}
+
+	ser = Make_Binary(len);
+	for (val = VAL_BLK_DATA(blk); NOT_END(val); val++) {
+		dg = (REBDGM*)STR_TAIL(ser);
+		dg->ip = sock->net.remote_ip;
+		dg->port = sock->net.remote_port;
+		if (IS_BINARY(val)) {
+			dg->length = VAL_LEN(val);
+			memcpy(dg + 1, VAL_BIN_DATA(val), dg->length);
+		}
+		else {
+			n = VAL_LEN(val);
+			Encode_UTF8((REBYTE *)(dg + 1), DGRAM_MAX, VAL_DATA(val), &n, !VAL_BYTE_SIZE(val), 0);
+			dg->length = n;
+		}
+		SERIES_TAIL(ser) += sizeof(REBDGM) + DGRAM_ALIGN(dg->length);
+	}
+
+	return ser;
+}
+
+
+/***********************************************************************
+**
+*/	static void Unpack_Datagrams(REBVAL *arg, REBCNT count)
 /*
+**		Convert a batch read buffer (see REBDGM) into a block of
+**		binaries, one per datagram received. ARG is updated.
+**
+***********************************************************************/
+{
+	REBSER *blk = Make_Block(count);
+	REBYTE *bp = VAL_BIN(arg);
+	REBDGM *dg;
+
+	for (; count > 0; count--, bp += DGRAM_STRIDE) {
+		dg = (REBDGM*)bp;
+		Set_Binary(Append_Value(blk), Copy_Bytes((REBYTE*)(dg + 1), MIN(dg->length, DGRAM_SLOT)));
+	}
+
+	Set_Block(arg, blk);
+}
+
+
+/***********************************************************************
+**
+*/	static int Transport_Actor(REBVAL *ds, REBSER *port, REBCNT action, enum Transport_Types proto)
+/*
+**		Shared actor for TCP and UDP ports. UDP differs in that
+**		each READ and WRITE is a whole datagram (or a batch of them)
+**		and that no connection is made: an opened UDP port sends to
+**		the remote host and receives from anyone.
+**
 ***********************************************************************/
 {
 	REBREQ *sock;	// IO request
@@ -128,6 +206,8 @@
 			arg = Obj_Value(spec, STD_PORT_SPEC_NET_HOST);
 			val = Obj_Value(spec, STD_PORT_SPEC_NET_PORT_ID);
 
+			if (proto == TRANSPORT_UDP) SET_FLAG(sock->modes, RST_UDP);
+
 			if (OS_DO_DEVICE(sock, RDC_OPEN)) Trap_Port(RE_CANNOT_OPEN, port, -12);
 			SET_OPEN(sock);
 
@@ -178,11 +258,15 @@
 		// This is normally called by the WAKE-UP function.
 		arg = OFV(port, STD_PORT_DATA);
 		if (sock->command == RDC_READ) {
-			if (ANY_BINSTR(arg)) VAL_TAIL(arg) += sock->actual;
+			if (GET_FLAG(sock->modes, RST_BATCH)) {
+				if (IS_BINARY(arg)) Unpack_Datagrams(arg, sock->actual);
+			}
+			else if (ANY_BINSTR(arg)) VAL_TAIL(arg) += sock->actual;
 		}
 		else if (sock->command == RDC_WRITE) {
 			SET_NONE(arg);  // Write is done.
 		}
+		CLR_FLAG(sock->modes, RST_BATCH);
 		return R_NONE;
 
 	case A_READ:
@@ -191,8 +275,34 @@
 		refs = Find_Refines(ds, ALL_READ_REFS);
 		if (!GET_FLAG(sock->state, RSM_CONNECT)) Trap_Port(RE_NOT_CONNECTED, port, -15);
 
-		// Setup the read buffer (allocate a buffer if needed):
 		arg = OFV(port, STD_PORT_DATA);
+
+		// Each UDP read gets whole datagrams. READ/PART asks for a
+		// batch of up to that many, returned as a block of binaries.
+		if (proto == TRANSPORT_UDP) {
+			if (refs & AM_READ_PART) {
+				len = Int32s(D_ARG(ARG_READ_LENGTH), 1);
+				if (len > UDP_BATCH_MAX) len = UDP_BATCH_MAX;
+				SET_FLAG(sock->modes, RST_BATCH);
+				ser = Make_Binary(len * DGRAM_STRIDE);
+				Set_Binary(arg, ser);
+				sock->length = len * DGRAM_STRIDE;
+			}
+			else {
+				CLR_FLAG(sock->modes, RST_BATCH);
+				// A new binary, as the last one may be in use:
+				ser = Make_Binary(DGRAM_MAX);
+				Set_Binary(arg, ser);
+				sock->length = DGRAM_MAX;
+			}
+			sock->data = BIN_HEAD(ser);
+			sock->actual = 0;
+			result = OS_DO_DEVICE(sock, RDC_READ);
+			if (result < 0) Trap_Port(RE_READ_ERROR, port, sock->error);
+			break;
+		}
+
+		// Setup the read buffer (allocate a buffer if needed):
 		if (!IS_STRING(arg) && !IS_BINARY(arg)) {
 			Set_Binary(arg, Make_Binary(NET_BUF_SIZE));
 		}
@@ -225,9 +335,21 @@
 		}
 
 		// Setup the write:
-		*OFV(port, STD_PORT_DATA) = *spec;	// keep it GC safe
-		sock->length = len;
-		sock->data = VAL_BIN_DATA(spec);
+		if (IS_BLOCK(spec)) {
+			// A block written to a UDP port sends one datagram per value:
+			if (proto != TRANSPORT_UDP) Trap_Arg(spec);
+			ser = Pack_Datagrams(sock, spec);
+			Set_Binary(OFV(port, STD_PORT_DATA), ser);	// keep it GC safe
+			SET_FLAG(sock->modes, RST_BATCH);
+			sock->length = SERIES_TAIL(ser);
+			sock->data = BIN_HEAD(ser);
+		}
+		else {
+			*OFV(port, STD_PORT_DATA) = *spec;	// keep it GC safe
+			CLR_FLAG(sock->modes, RST_BATCH);
+			sock->length = len;
+			sock->data = VAL_BIN_DATA(spec);
+		}
 		sock->actual = 0;
 
 		//Print("(write length %d)", len);
@@ -239,7 +361,7 @@
 	case A_PICK:
 		// FIRST server-port returns new port connection.
 		len = Get_Num_Arg(arg); // Position
-		if (len == 1 && GET_FLAG(sock->modes, RST_LISTEN) && sock->data)
+		if (len == 1 && GET_FLAG(sock->modes, RST_LISTEN) && !GET_FLAG(sock->modes, RST_UDP) && sock->data)
 			Accept_New_Port(ds, port, sock); // sets D_RET
 		else
 			Trap_Range(arg);
@@ -294,6 +416,26 @@
 }
 
 
+/***********************************************************************
+**
+*/	static int TCP_Actor(REBVAL *ds, REBSER *port, REBCNT action)
+/*
+***********************************************************************/
+{
+	return Transport_Actor(ds, port, action, TRANSPORT_TCP);
+}
+
+
+/***********************************************************************
+**
+*/	static int UDP_Actor(REBVAL *ds, REBSER *port, REBCNT action)
+/*
+***********************************************************************/
+{
+	return Transport_Actor(ds, port, action, TRANSPORT_UDP);
+}
+
+
 /***********************************************************************
 **
 */	void Init_TCP_Scheme(void)
@@ -302,3 +444,13 @@
 {
 	Register_Scheme(SYM_TCP, 0, TCP_Actor);
 }
+
+
+/***********************************************************************
+**
+*/	void Init_UDP_Scheme(void)
+/*
+***********************************************************************/
+{
+	Register_Scheme(SYM_UDP, 0, UDP_Actor);
+}
@@ -547,7 +547,7 @@ STOID Mold_Tag(REBVAL *value, REB_MOLD *mold)
 		break;
 	case 64:
 		Append_Bytes(mold->series, "64");
-		out = Encode_Base64(value, 0, len > 64);
+		out = Encode_Base64(value, 0, len > 64, FALSE);
 		break;
 	case 2:
 		Append_Byte(mold->series, '2');
@@ -585,6 +585,48 @@ STOID Mold_All_String(REBVAL *value, REB_MOLD *mold)
 ************************************************************************
 ***********************************************************************/
 
+#define MAX_NUM_MOLD 32		// most chars in a molded integer or decimal, and separator
+#define NUM_MOLD_CHUNK 1024	// numbers molded per expansion of the output
+
+static REBVAL *Mold_Numbers(REB_MOLD *mold, REBVAL *value, REBUNI sep, REBFLG lines)
+{
+	// Mold a run of integers and decimals, up to the first value that
+	// is not one (or, if lines, that starts a new line). Numbers are
+	// formed straight into the output, which is expanded for a chunk
+	// of them at a time. Returns the value after the run.
+	REBSER *out = mold->series;
+	REBYTE point = Punctuation[GET_MOPT(mold, MOPT_COMMA_PT) ? PUNCT_COMMA : PUNCT_DOT];
+	REBYTE buf[MAX_NUM_MOLD];
+	REBUNI *dp = 0;
+	REBCNT room = 0;
+	REBCNT tail;
+	REBINT len;
+	REBINT n;
+
+	for (;;) {
+		if (!room) {
+			tail = dp ? (REBCNT)(dp - UNI_HEAD(out)) : SERIES_TAIL(out);
+			SERIES_TAIL(out) = tail;
+			EXPAND_SERIES_TAIL(out, NUM_MOLD_CHUNK * MAX_NUM_MOLD);
+			dp = UNI_SKIP(out, tail);
+			room = NUM_MOLD_CHUNK;
+		}
+		room--;
+
+		if (IS_INTEGER(value)) len = Emit_Integer(buf, VAL_INT64(value));
+		else len = Emit_Decimal(buf, VAL_DECIMAL(value), 0, point, mold->digits);
+		for (n = 0; n < len; n++) *dp++ = buf[n];
+
+		value++;
+		if (!(IS_INTEGER(value) || IS_DECIMAL(value)) || (lines && VAL_GET_LINE(value))) break;
+		*dp++ = sep;
+	}
+
+	SERIES_TAIL(out) = (REBCNT)(dp - UNI_HEAD(out));
+	*dp = 0;
+	return value;
+}
+
 STOID Mold_Block_Series(REB_MOLD *mold, REBSER *series, REBCNT index, REBYTE *sep)
 {
 	REBSER *out = mold->series;
@@ -622,8 +664,12 @@ STOID Mold_Block_Series(REB_MOLD *mold, REBSER *series, REBCNT index, REBYTE *se
 			had_lines = TRUE;
 		}
 		line_flag = TRUE;
-		Mold_Value(mold, value, TRUE);
-		value++;
+		if (IS_INTEGER(value) || IS_DECIMAL(value))
+			value = Mold_Numbers(mold, value, (sep[0] == '/') ? '/' : ' ', TRUE);
+		else {
+			Mold_Value(mold, value, TRUE);
+			value++;
+		}
 		if (NOT_END(value))
 			Append_Byte(out, (sep[0] == '/') ? '/' : ' ');
 	}
@@ -741,6 +787,14 @@ STOID Form_Block_Series(REBSER *blk, REBCNT index, REB_MOLD *mold, REBSER *frame
 			wval = Find_Word_Value(frame, VAL_WORD_SYM(val));
 			if (wval) val = wval;
 		}
+		if (
+			!wval && (IS_INTEGER(val) || IS_DECIMAL(val))
+			&& !GET_MOPT(mold, MOPT_LINES) && !GET_MOPT(mold, MOPT_TIGHT)
+		) {
+			n += Mold_Numbers(mold, val, ' ', FALSE) - val;
+			if (n < len) Append_Byte(mold->series, ' ');
+			continue;
+		}
 		Mold_Value(mold, val, wval != 0);
 		n++;
 		if (GET_MOPT(mold, MOPT_LINES)) {
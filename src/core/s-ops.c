@@ -29,6 +29,39 @@
 
 #include "sys-core.h"
 #include "sys-scan.h"
+#include "sys-simd.h"
+
+
+#ifdef USE_CPU_FLAGS
+/*********************************************************************
+**
+*/	int CPU_Flags(void)
+/*
+**		Returns the CPU_* flags of the instructions this CPU has.
+**		Asks the CPU only once.
+**
+***********************************************************************/
+{
+	static int flags = -1;
+	int r[4];
+	int max;
+
+	if (flags >= 0) return flags;
+	flags = 0;
+	CPUID(0, r);
+	max = r[0];
+	if (max < 1) return flags;
+	CPUID(1, r);
+	if (r[2] & (1 << 20)) flags |= CPU_SSE42;
+	if (r[2] & (1 << 9)) flags |= CPU_SSSE3;
+	if (!(r[2] & (1 << 19)) || !(r[2] & (1 << 9))) return flags; // SSE4.1, SSSE3
+	if (r[2] & (1 << 1)) flags |= CPU_PCLMUL;
+	if (max < 7) return flags;
+	CPUID(7, r);
+	if (r[1] & (1 << 29)) flags |= CPU_SHA;
+	return flags;
+}
+#endif
 
 
 /*********************************************************************
@@ -39,6 +72,10 @@
 **
 ***********************************************************************/
 {
+#ifdef USE_SSE2
+	for (; len >= 16; len -= 16, bp += 16)
+		if (HIGH_BITS(LOAD_16(bp))) return TRUE;
+#endif
 	for (; len > 0; len--, bp++)
 		if (*bp >= 0x80) return TRUE;
 
@@ -54,6 +91,12 @@
 **
 ***********************************************************************/
 {
+#ifdef USE_SSE2
+	// Any high byte not zero:
+	__m128i zero = _mm_setzero_si128();
+	for (; len >= 8; len -= 8, up += 8)
+		if (HIGH_BITS(_mm_cmpeq_epi16(_mm_srli_epi16(LOAD_16(up), 8), zero)) != 0xFFFF) return TRUE;
+#endif
 	for (; len > 0; len--, up++)
 		if (*up >= 0x100) return TRUE;
 
@@ -732,45 +775,239 @@ static REBYTE seed_str[SEED_LEN] = {
 }
 
 
+typedef struct reb_delim_set {
+	REBYTE map[256];	// bytes that may begin a delimiter
+	REBYTE chrs[4];		// the same bytes, when there are four or fewer
+	REBCNT count;		// bytes in the map
+} DELIM_SET;
+
+
 /***********************************************************************
 **
-*/  REBSER *Split_Lines(REBVAL *val)
+*/	static void Set_Delim_Char(DELIM_SET *set, REBCNT c, REBFLG uncase)
 /*
-**      Given a string series, split lines on CR-LF.
-**		Series can be bytes or Unicode.
+***********************************************************************/
+{
+	if (c < 256) set->map[c] = 1;
+	if (uncase && c < UNICODE_CASES) {
+		if (UP_CASE(c) < 256) set->map[UP_CASE(c)] = 1;
+		if (LO_CASE(c) < 256) set->map[LO_CASE(c)] = 1;
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void Make_Delim_Set(DELIM_SET *set, REBVAL *dlm, REBFLG uncase)
+/*
+**		Find the bytes that can begin a delimiter in byte input.
+**		The dlm is 0 for line ends.
 **
 ***********************************************************************/
 {
-	REBSER *ser = BUF_EMIT; // GC protected (because it is emit buffer)
-	REBSER *str = VAL_SERIES(val);
-	REBCNT len = VAL_LEN(val);
-	REBCNT idx = VAL_INDEX(val);
-	REBCNT start = idx;
-	REBSER *out;
-	REBCHR c;
-
-	BLK_RESET(ser);
-
-	while (idx < len) {
-		c = GET_ANY_CHAR(str, idx);
-		if (c == LF || c == CR) {
-			out = Copy_String(str, start, idx - start);
-			val = Append_Value(ser);
-			SET_STRING(val, out);
-			VAL_SET_LINE(val);
-			idx++;
-			if (c == CR && GET_ANY_CHAR(str, idx) == LF) idx++;
-			start = idx;
+	REBCNT c;
+
+	CLEARS(set);
+
+	if (!dlm) {
+		set->map[CR] = set->map[LF] = 1;
+	}
+	else if (IS_BITSET(dlm)) {
+		for (c = 0; c < 256; c++)
+			set->map[c] = (REBYTE)Check_Bit(VAL_SERIES(dlm), c, uncase);
+	}
+	else if (IS_CHAR(dlm)) {
+		Set_Delim_Char(set, VAL_CHAR(dlm), uncase);
+	}
+	else {
+		Set_Delim_Char(set, IS_BINARY(dlm) ? *VAL_BIN_DATA(dlm) : VAL_ANY_CHAR(dlm), uncase);
+	}
+
+	for (c = 0; c < 256; c++) {
+		if (set->map[c]) {
+			if (set->count < 4) set->chrs[set->count] = (REBYTE)c;
+			set->count++;
+		}
+	}
+	// Unused compares repeat the first byte:
+	for (c = set->count; c < 4; c++) set->chrs[c] = set->chrs[0];
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Scan_Delim(DELIM_SET *set, REBYTE *bp, REBCNT index, REBCNT tail)
+/*
+**		Return the index of the next byte that may begin a
+**		delimiter, or the tail.
+**
+***********************************************************************/
+{
+#ifdef USE_SSE2
+	if (set->count > 0 && set->count <= 4) {
+		__m128i c0 = SPLAT(set->chrs[0]);
+		__m128i c1 = SPLAT(set->chrs[1]);
+		__m128i c2 = SPLAT(set->chrs[2]);
+		__m128i c3 = SPLAT(set->chrs[3]);
+		__m128i v;
+		unsigned int hits;
+
+		for (; index + 16 <= tail; index += 16) {
+			v = LOAD_16(bp + index);
+			hits = HIGH_BITS(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, c0), _mm_cmpeq_epi8(v, c1)),
+				_mm_or_si128(_mm_cmpeq_epi8(v, c2), _mm_cmpeq_epi8(v, c3))
+			));
+			if (hits) return index + Lowest_Bit(hits);
 		}
-		else idx++;
 	}
-	// Possible remainder (no terminator)
-	if (idx > start) {
-		out = Copy_String(str, start, idx - start);
-		val = Append_Value(ser);
-		SET_STRING(val, out);
-		VAL_SET_LINE(val);
+#endif
+	if (set->count == 0) return tail;
+	for (; index < tail; index++)
+		if (set->map[bp[index]]) return index;
+
+	return tail;
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Match_Delim(REBSER *ser, REBCNT index, REBCNT tail, REBVAL *dlm, REBFLG uncase)
+/*
+**		Return the length of the delimiter at the index, or zero.
+**		The dlm is 0 for line ends (LF, CR, or CR LF).
+**
+***********************************************************************/
+{
+	REBCNT c = GET_ANY_CHAR(ser, index);
+	REBCNT c2;
+	REBCNT len;
+
+	if (!dlm) {
+		if (c == LF) return 1;
+		if (c != CR) return 0;
+		return (index + 1 < tail && GET_ANY_CHAR(ser, index + 1) == LF) ? 2 : 1;
 	}
 
-	return Copy_Block(ser, 0);
+	if (IS_BITSET(dlm)) return Check_Bit(VAL_SERIES(dlm), c, uncase) ? 1 : 0;
+
+	if (IS_CHAR(dlm)) {
+		c2 = VAL_CHAR(dlm);
+		if (uncase && c < UNICODE_CASES && c2 < UNICODE_CASES) {
+			c = UP_CASE(c);
+			c2 = UP_CASE(c2);
+		}
+		return (c == c2) ? 1 : 0;
+	}
+
+	len = VAL_LEN(dlm);
+	if (index + len > tail) return 0;
+	return (NOT_FOUND != Find_Str_Str(ser, 0, index, tail, 1, VAL_SERIES(dlm), VAL_INDEX(dlm), len,
+		AM_FIND_MATCH | (uncase ? 0 : AM_FIND_CASE))) ? len : 0;
+}
+
+
+/***********************************************************************
+**
+*/	REBVAL *Append_Piece(REBSER *blk, REBVAL *val, REBCNT start, REBCNT end, REBFLG positions)
+/*
+**		Append a copy of part of the series of val to the block.
+**		Or with positions, its head and tail index (1 based).
+**		Returns the value appended (the tail index for positions).
+**
+***********************************************************************/
+{
+	REBVAL *out;
+	REBSER *ser;
+
+	out = Append_Value(blk);
+	if (positions) {
+		SET_INTEGER(out, start + 1);
+		out = Append_Value(blk);
+		SET_INTEGER(out, end + 1);
+		return out;
+	}
+
+	SET_NONE(out); // (in case of GC)
+	ser = ANY_BLOCK(val)
+		? Copy_Block_Len(VAL_SERIES(val), start, end - start)
+		: Copy_String(VAL_SERIES(val), start, end - start);
+	Set_Series(VAL_TYPE(val), out, ser);
+
+	return out;
+}
+
+
+/***********************************************************************
+**
+*/  REBSER *Split_String(REBVAL *val, REBVAL *dlm, REBFLG positions)
+/*
+**		Split a string or binary at each delimiter: a char, a
+**		string, or a bitset of chars. Letters match either case,
+**		except in binary. With dlm 0, split at line ends.
+**
+**		Returns a block of the pieces (copies), or with positions,
+**		the head and tail index of each piece (so the input need
+**		not be copied at all).
+**
+**		A delimiter at the end leaves an empty last piece, but
+**		a line end does not.
+**
+**		Byte input is scanned for the bytes that can begin a
+**		delimiter, 16 at a time where SSE2 is available.
+**
+***********************************************************************/
+{
+	REBSER *ser = VAL_SERIES(val);
+	REBCNT tail = VAL_TAIL(val);
+	REBCNT index = MIN(VAL_INDEX(val), tail);
+	REBCNT start = index;
+	REBFLG uncase = !IS_BINARY(val);
+	REBSER *blk;
+	REBVAL *out;
+	DELIM_SET set;
+	REBCNT len;
+
+	if (dlm && !IS_CHAR(dlm) && !IS_BITSET(dlm) && VAL_LEN(dlm) == 0) Trap_Arg(dlm);
+
+	blk = Make_Block(8);
+	SAVE_SERIES(blk);
+
+	if (BYTE_SIZE(ser)) Make_Delim_Set(&set, dlm, uncase);
+
+	while (index < tail) {
+		if (BYTE_SIZE(ser)) {
+			index = Scan_Delim(&set, BIN_HEAD(ser), index, tail);
+			if (index == tail) break;
+		}
+		len = Match_Delim(ser, index, tail, dlm, uncase);
+		if (len) {
+			out = Append_Piece(blk, val, start, index, positions);
+			if (!dlm && !positions) VAL_SET_LINE(out);
+			index = start = index + len;
+		}
+		else index++;
+	}
+
+	// The last piece:
+	if (dlm ? tail > MIN(VAL_INDEX(val), tail) : start < tail) {
+		out = Append_Piece(blk, val, start, tail, positions);
+		if (!dlm && !positions) VAL_SET_LINE(out);
+	}
+
+	UNSAVE_SERIES(blk);
+	return blk;
+}
+
+
+/***********************************************************************
+**
+*/  REBSER *Split_Lines(REBVAL *val)
+/*
+**      Given a string series, split lines on CR-LF.
+**		Series can be bytes or Unicode.
+**
+***********************************************************************/
+{
+	return Split_String(val, 0, FALSE);
 }
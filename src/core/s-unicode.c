@@ -111,6 +111,7 @@
 ------------------------------------------------------------------------ */
 
 #include "sys-core.h"
+#include "sys-simd.h"
 
 
 /* ---------------------------------------------------------------------
@@ -758,6 +759,11 @@ ConversionResult ConvertUTF8toUTF32 (
 	REBYTE *end = str + len;
 
 	for (;str < end; str += n) {
+#ifdef USE_SSE2
+		// Skip plain ASCII 16 bytes at a time:
+		while (str + 16 <= end && !HIGH_BITS(LOAD_16(str))) str += 16;
+		if (str >= end) break;
+#endif
 		n = trailingBytesForUTF8[*str] + 1;
 		if (str + n > end || !isLegalUTF8(str, n)) return str;
 	}
@@ -815,6 +821,36 @@ ConversionResult ConvertUTF8toUTF32 (
 }
 
 
+#ifdef USE_SSE2
+/***********************************************************************
+**
+*/	static REBCNT Widen_ASCII(REBUNI *dst, REBYTE *src, REBCNT len, REBFLG ccr)
+/*
+**		Copy the plain ASCII chars at the start of src, 16 at a time.
+**		Stops at any UTF8 byte, and at CR when converting line ends.
+**		Returns the number of chars copied. Whole blocks are always
+**		stored, so dst must have room for len chars.
+**
+***********************************************************************/
+{
+	__m128i v, zero = _mm_setzero_si128();
+	unsigned int stops;
+	REBCNT n;
+
+	for (n = 0; n + 16 <= len; n += 16) {
+		v = LOAD_16(src + n);
+		stops = HIGH_BITS(v);
+		if (ccr) stops |= HIGH_BITS(IS_CHR(v, CR));
+		STORE_16(dst + n, _mm_unpacklo_epi8(v, zero));
+		STORE_16(dst + n + 8, _mm_unpackhi_epi8(v, zero));
+		if (stops) return n + Lowest_Bit(stops);
+	}
+
+	return n;
+}
+#endif
+
+
 /***********************************************************************
 **
 */	int Decode_UTF8(REBUNI *dst, REBYTE *src, REBCNT len, REBFLG ccr)
@@ -834,14 +870,39 @@ ConversionResult ConvertUTF8toUTF32 (
 	int flag = -1;
 	UTF32 ch;
 	REBUNI *start = dst;
+	REBCNT n;
 
 	for (; len > 0; len--, src++) {
+#ifdef USE_SSE2
+		if (len >= 16 && *src < 0x80 && (n = Widen_ASCII(dst, src, len, ccr))) {
+			dst += n;
+			src += n - 1; // the loop steps past the last one
+			len -= n - 1;
+			continue;
+		}
+#endif
 		if ((ch = *src) >= 0x80) {
-			ch = Decode_UTF8_Char(&src, &len);
-			if (ch == 0) ch = UNI_REPLACEMENT_CHAR; // temporary!
+			// Well formed 2 and 3 byte chars are the most common, so
+			// are done here. Others (and all errors) take the long way:
+			if (ch >= 0xC2 && ch < 0xE0 && len >= 2 && (src[1] & 0xC0) == 0x80) {
+				ch = ((ch & 0x1F) << 6) | (src[1] & 0x3F);
+				src++, len--;
+			}
+			else if ((ch & 0xF0) == 0xE0 && len >= 3
+				&& (src[1] & 0xC0) == 0x80 && (src[2] & 0xC0) == 0x80
+				&& (ch != 0xE0 || src[1] >= 0xA0)  // not overlong
+				&& (ch != 0xED || src[1] < 0xA0)   // not a surrogate
+			) {
+				ch = ((ch & 0x0F) << 12) | ((src[1] & 0x3F) << 6) | (src[2] & 0x3F);
+				src += 2, len -= 2;
+			}
+			else {
+				ch = Decode_UTF8_Char(&src, &len);
+				if (ch == 0) ch = UNI_REPLACEMENT_CHAR; // temporary!
+			}
 			if (ch > 0xff) flag = 1;
 		} if (ch == CR && ccr) {
-			if (src[1] == LF) continue;
+			if (len > 1 && src[1] == LF) continue;
 			ch = LF;
 		}
 		*dst++ = (REBUNI)ch;
@@ -974,6 +1035,32 @@ ConversionResult ConvertUTF8toUTF32 (
 	REBCNT c;
 	REBYTE *bp = (REBYTE*)src;
 
+#ifdef USE_SSE2
+	// A byte for each char, plus one for each of 0x80 and up,
+	// plus one more for each of 0x800 and up (counted 16 bytes
+	// at a time; movemask gives two bits for each REBUNI):
+	__m128i v, zero = _mm_setzero_si128();
+	if (uni) {
+		for (; len >= 8; len -= 8, src += 8) {
+			v = LOAD_16(src);
+			size += 16 - Count_Bits(HIGH_BITS(_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xFF80)), zero))) / 2;
+			size += 8 - Count_Bits(HIGH_BITS(_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xF800)), zero))) / 2;
+#ifdef TO_WIN32
+			if (ccr) size += Count_Bits(HIGH_BITS(_mm_cmpeq_epi16(v, _mm_set1_epi16(LF)))) / 2;
+#endif
+		}
+	}
+	else {
+		for (; len >= 16; len -= 16, bp += 16) {
+			v = LOAD_16(bp);
+			size += 16 + Count_Bits(HIGH_BITS(v));
+#ifdef TO_WIN32
+			if (ccr) size += Count_Bits(HIGH_BITS(IS_CHR(v, LF)));
+#endif
+		}
+	}
+#endif
+
 	for (; len > 0; len--) {
 		c = uni ? *src++ : *bp++;
 		if (c < (UTF32)0x80) {
@@ -1028,6 +1115,44 @@ ConversionResult ConvertUTF8toUTF32 (
 }
 
 
+#ifdef USE_SSE2
+/***********************************************************************
+**
+*/	static REBCNT Narrow_ASCII(REBYTE *dst, void *src, REBCNT len, REBFLG uni, REBFLG ccr)
+/*
+**		Copy the plain ASCII chars at the start of a byte or REBUNI
+**		string, 16 at a time. Stops at any other char, and at LF
+**		when it must become CRLF. Returns the number of chars copied.
+**		Whole blocks are always stored, so dst must have room for len.
+**
+***********************************************************************/
+{
+	__m128i v, a, b;
+	unsigned int stops;
+	REBCNT n;
+
+	for (n = 0; n + 16 <= len; n += 16) {
+		if (uni) {
+			// Saturated packing sets the high bit for all chars above
+			// 0x7F: unsigned for 0x80 to 0x7FFF, signed for the rest.
+			a = LOAD_16((REBUNI *)src + n);
+			b = LOAD_16((REBUNI *)src + n + 8);
+			v = _mm_packus_epi16(a, b);
+			stops = HIGH_BITS(_mm_or_si128(v, _mm_packs_epi16(a, b)));
+		}
+		else stops = HIGH_BITS(v = LOAD_16((REBYTE *)src + n));
+#ifdef TO_WIN32
+		if (ccr) stops |= HIGH_BITS(IS_CHR(v, LF));
+#endif
+		STORE_16(dst + n, v);
+		if (stops) return n + Lowest_Bit(stops);
+	}
+
+	return n;
+}
+#endif
+
+
 /***********************************************************************
 **
 */	REBCNT Encode_UTF8(REBYTE *dst, REBINT max, void *src, REBCNT *len, REBFLG uni, REBFLG ccr)
@@ -1044,7 +1169,6 @@ ConversionResult ConvertUTF8toUTF32 (
 {
 	REBUNI c;
 	REBINT n;
-	REBYTE buf[8];
 	REBYTE *bs = dst; // save start
 	REBYTE *bp = (REBYTE*)src;
 	REBUNI *up = (REBUNI*)src;
@@ -1056,12 +1180,23 @@ ConversionResult ConvertUTF8toUTF32 (
 	}
 
 	for (; max > 0 && cnt > 0; cnt--) {
+#ifdef USE_SSE2
+		if (cnt >= 16 && max >= 16 && (uni ? *up : *bp) < 0x80
+			&& (n = Narrow_ASCII(dst, uni ? (void*)up : (void*)bp, MIN(cnt, (REBCNT)max), uni, ccr))
+		) {
+			if (uni) up += n; else bp += n;
+			dst += n;
+			max -= n;
+			cnt -= n - 1; // the loop counts the last one
+			continue;
+		}
+#endif
 		c = uni ? *up++ : *bp++;
 		if (c < 0x80) {
 #if defined(TO_WIN32)
 			if (ccr && c == LF) {
 				// If there's not room, don't try to output CRLF
-				if (2 > max) {up--; break;}
+				if (2 > max) {if (uni) up--; else bp--; break;}
 				*dst++ = CR;
 				max--;
 				c = LF;
@@ -1070,12 +1205,18 @@ ConversionResult ConvertUTF8toUTF32 (
 			*dst++ = (REBYTE)c;
 			max--;
 		}
-		else {
-			n = Encode_UTF8_Char(buf, c);
-			if (n > max) {up--; break;}
-			memcpy(dst, buf, n);
-			dst += n;
-			max -= n;
+		else if (c < 0x800) {
+			if (2 > max) {if (uni) up--; else bp--; break;}
+			*dst++ = (REBYTE)(0xC0 | (c >> 6));
+			*dst++ = (REBYTE)(0x80 | (c & 0x3F));
+			max -= 2;
+		}
+		else { // (REBUNI is never above 0xFFFF)
+			if (3 > max) {if (uni) up--; else bp--; break;}
+			*dst++ = (REBYTE)(0xE0 | (c >> 12));
+			*dst++ = (REBYTE)(0x80 | ((c >> 6) & 0x3F));
+			*dst++ = (REBYTE)(0x80 | (c & 0x3F));
+			max -= 3;
 		}
 	}
 
@@ -1130,39 +1271,31 @@ ConversionResult ConvertUTF8toUTF32 (
 */	REBSER *Encode_UTF8_Value(REBVAL *arg, REBCNT len, REBFLG opts)
 /*
 **		Do all the details to encode a string as UTF8.
-**		No_copy means do not make a copy.
-**		Result can be a shared buffer!
+**		No_copy means do not make a copy (of an ASCII string,
+**		which returns zero).
+**		The size is computed exactly first, so the result is
+**		encoded directly into a new series.
 **
 ***********************************************************************/
 {
-	REBSER *ser = BUF_FORM; // a shared buffer
+	REBSER *ser;
 	REBCNT size;
-	REBYTE *cp;
+	REBFLG uni = !VAL_BYTE_SIZE(arg);
+	void *src = uni ? (void*)VAL_UNI_DATA(arg) : (void*)VAL_BIN_DATA(arg);
 	REBFLG ccr = GET_FLAG(opts, ENC_OPT_CRLF);
 
-	if (VAL_BYTE_SIZE(arg)) {
-		REBYTE *bp = VAL_BIN_DATA(arg);
-
-		if (Is_Not_ASCII(bp, len)) {
-			size = Length_As_UTF8((REBUNI*)bp, len, FALSE, (REBOOL)ccr);
-			cp = Reset_Buffer(ser, size + (GET_FLAG(opts, ENC_OPT_BOM) ? 3 : 0));
-			Encode_UTF8(cp, size, bp, &len, FALSE, ccr);
-		}
-		else if (GET_FLAG(opts, ENC_OPT_NO_COPY)) return 0;
-		else return Copy_Bytes(bp, len);
-
-	} else {
-		REBUNI *up = VAL_UNI_DATA(arg);
-
-		size = Length_As_UTF8(up, len, TRUE, (REBOOL)ccr);
-		cp = Reset_Buffer(ser, size + (GET_FLAG(opts, ENC_OPT_BOM) ? 3 : 0));
-		Encode_UTF8(Reset_Buffer(ser, size), size, up, &len, TRUE, ccr);
+	if (!uni && !Is_Not_ASCII(src, len)) {
+		if (GET_FLAG(opts, ENC_OPT_NO_COPY)) return 0;
+		return Copy_Bytes(src, len);
 	}
 
+	size = Length_As_UTF8(src, len, uni, (REBOOL)ccr);
+	ser = Make_Binary(size);
+	Encode_UTF8(BIN_HEAD(ser), size, src, &len, uni, ccr);
 	SERIES_TAIL(ser) = len;
 	STR_TERM(ser);
 
-	return Copy_Bytes(BIN_HEAD(ser), len);
+	return ser;
 }
 
 
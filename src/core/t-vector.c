@@ -615,9 +615,11 @@ bad_make:
 	REBCNT len;
 	REBCNT n;
 	REBCNT c;
+	REBCNT end;
 	union {REBU64 i; REBDEC d;} v;
 	REBYTE buf[32];
-	REBYTE l;
+	REBUNI *dp;
+	REBINT l;
 
 	if (GET_MOPT(mold, MOPT_MOLD_ALL)) {
 		len = VAL_TAIL(value);
@@ -636,26 +638,25 @@ bad_make:
 		if (len) New_Indented_Line(mold);
 	}
 
-	c = 0;
-	for (; n < vect->tail; n++) {
-		v.i = get_vect(bits, data, n);
-		if (bits < VTSF08) {
-			l = Emit_Integer(buf, v.i);
-		} else {
-			l = Emit_Decimal(buf, v.d, 0, '.', mold->digits);
-		}
-		Append_Bytes_Len(mold->series, buf, l);
-
-		if ((++c > 7) && (n+1 < vect->tail)) {
-			New_Indented_Line(mold);
-			c = 0;
+	// Eight values per line, formed straight into the output:
+	while (n < vect->tail) {
+		end = MIN(n + 8, vect->tail);
+		dp = Prep_Uni_Series(mold, (end - n) * 32);
+		for (; n < end; n++) {
+			v.i = get_vect(bits, data, n);
+			if (bits < VTSF08) {
+				l = Emit_Integer(buf, v.i);
+			} else {
+				l = Emit_Decimal(buf, v.d, 0, '.', mold->digits);
+			}
+			for (c = 0; c < (REBCNT)l; c++) *dp++ = buf[c];
+			*dp++ = ' ';
 		}
-		else
-			Append_Byte(mold->series, ' '); 
+		mold->series->tail = (REBCNT)(dp - UNI_HEAD(mold->series)) - 1; // remove final space
+		*--dp = 0;
+		if (n < vect->tail) New_Indented_Line(mold);
 	}
 
-	if (len) mold->series->tail--; // remove final space
-
 	if (molded) {
 		if (len) New_Indented_Line(mold);
 		Append_Byte(mold->series, ']');
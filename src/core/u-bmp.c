@@ -598,7 +598,7 @@ error:
 		return CODI_IMAGE;
 	}
 
-	if (codi->action == CODI_ENCODE) {
+	if (codi->action == CODI_ENCODE && codi->bits) { // (not for a block)
 		Encode_BMP_Image(codi);
 		return CODI_BINARY;
 	}
@@ -0,0 +1,525 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  u-csv.c
+**  Summary: CSV data conversion
+**  Section: utility
+**  Notes:
+**    Decodes CSV text (RFC 4180, UTF-8) to a block of rows, each a
+**    block of fields, and encodes rows back. A field in quotes can
+**    hold separators, line ends, and doubled quotes. Other fields
+**    that are numbers become integer! or decimal! (converted here,
+**    not by the scanner), empty ones become none, the rest strings.
+**    Blank lines are skipped. Encode writes CRLF line ends.
+**
+**    Options (DECODE/options and ENCODE/options):
+**        #";"     - separator char (default is comma)
+**        columns  - decode to a block of columns; a column is a
+**                   vector! if all its fields are numbers
+**        strings  - keep all fields as strings (no numbers, none)
+**        more     - the data continues: decode only whole rows
+**                   (see REBCDI ->len; used by DECODE of a port)
+**
+***********************************************************************/
+
+#include "sys-core.h"
+#include "sys-simd.h"
+
+enum CSV_Flags {
+	CSV_COLUMNS = 1,
+	CSV_STRINGS = 2,
+	CSV_MORE = 4,
+};
+
+typedef struct reb_csv {
+	REBYTE *head;		// data
+	REBYTE *end;
+	REBYTE sep;			// field separator
+	REBCNT flags;
+	REBSER *buf;		// for quoted fields
+} REBCSV;
+
+
+/***********************************************************************
+**
+*/	static void CSV_Options(REBCSV *csv, REBVAL *opts)
+/*
+***********************************************************************/
+{
+	REBVAL *val;
+
+	csv->sep = ',';
+	csv->flags = 0;
+	if (!opts) return;
+
+	for (val = VAL_BLK_DATA(opts); NOT_END(val); val++) {
+		if (IS_CHAR(val) && VAL_CHAR(val) < 0x80
+			&& VAL_CHAR(val) != '"' && VAL_CHAR(val) != CR && VAL_CHAR(val) != LF)
+			csv->sep = (REBYTE)VAL_CHAR(val);
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_COLUMNS)
+			csv->flags |= CSV_COLUMNS;
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_STRINGS)
+			csv->flags |= CSV_STRINGS;
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_MORE)
+			csv->flags |= CSV_MORE;
+		else
+			Trap_Arg(val);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *Scan_CSV_Field(REBYTE *cp, REBYTE *end, REBYTE sep)
+/*
+**		Return the end of an unquoted field: its separator, CR,
+**		LF, or the end of the data.
+**
+***********************************************************************/
+{
+#ifdef USE_SSE2
+	__m128i s = SPLAT(sep);
+	__m128i cr = SPLAT(CR);
+	__m128i lf = SPLAT(LF);
+	__m128i v;
+	unsigned int hits;
+
+	for (; cp + 16 <= end; cp += 16) {
+		v = LOAD_16(cp);
+		hits = HIGH_BITS(_mm_or_si128(_mm_cmpeq_epi8(v, s),
+			_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf))));
+		if (hits) return cp + Lowest_Bit(hits);
+	}
+#endif
+	for (; cp < end; cp++)
+		if (*cp == sep || *cp == CR || *cp == LF) break;
+
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBFLG CSV_Number(REBVAL *val, REBYTE *cp, REBCNT len)
+/*
+**		Set an integer or decimal if the field is one, in plain
+**		form: optional sign, digits, fraction, exponent. Integers
+**		too big for 64 bits become decimals.
+**
+***********************************************************************/
+{
+	REBYTE *bp = cp;
+	REBYTE *ep = cp + len;
+	REBU64 n = 0;
+	REBU64 max = (*cp == '-') ? (REBU64)MAX_I64 + 1 : (REBU64)MAX_I64;
+	REBFLG over = FALSE;
+	REBCNT digits = 0;
+	REBCNT exp = 0;
+
+	if (*bp == '-' || *bp == '+') bp++;
+	for (; bp < ep && *bp >= '0' && *bp <= '9'; bp++, digits++) {
+		if (n > (max - (*bp - '0')) / 10) over = TRUE;
+		else n = n * 10 + (*bp - '0');
+	}
+
+	if (bp == ep) {
+		if (digits == 0) return FALSE;
+		if (!over) {
+			SET_INTEGER(val, (*cp == '-') ? (REBI64)(0 - n) : (REBI64)n);
+			return TRUE;
+		}
+	}
+	else {
+		if (*bp == '.') {
+			for (bp++; bp < ep && *bp >= '0' && *bp <= '9'; bp++, digits++);
+		}
+		if (digits == 0) return FALSE;
+		if (bp < ep && (*bp == 'e' || *bp == 'E')) {
+			bp++;
+			if (bp < ep && (*bp == '-' || *bp == '+')) bp++;
+			if (bp == ep) return FALSE;
+			for (; bp < ep && *bp >= '0' && *bp <= '9'; bp++)
+				if ((exp = exp * 10 + (*bp - '0')) > 300) return FALSE; // (out of range)
+		}
+		if (bp != ep) return FALSE;
+	}
+
+	return Scan_Decimal(cp, len, val, TRUE) != 0;
+}
+
+
+/***********************************************************************
+**
+*/	static void CSV_Field(REBCSV *csv, REBVAL *val, REBYTE *cp, REBCNT len)
+/*
+**		Set the value of an unquoted field.
+**
+***********************************************************************/
+{
+	if (!(csv->flags & CSV_STRINGS)) {
+		if (len == 0) return; // (none)
+		if (CSV_Number(val, cp, len)) return;
+	}
+	Set_String(val, Append_UTF8(0, cp, len));
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *CSV_Quoted(REBCSV *csv, REBVAL *val, REBYTE *cp)
+/*
+**		Set the string of a quoted field. Text after the closing
+**		quote (not valid CSV) is kept too. Returns the end of the
+**		field, or 0 if the data ends before it does (for more).
+**
+***********************************************************************/
+{
+	REBSER *buf = csv->buf;
+	REBYTE *end = csv->end;
+	REBYTE *ep;
+
+	RESET_TAIL(buf);
+	cp++; // opening quote
+
+	for (;;) {
+		ep = memchr(cp, '"', end - cp);
+		if (!ep) {
+			if (csv->flags & CSV_MORE) return 0;
+			Append_Bytes_Len(buf, cp, end - cp);
+			cp = end;
+			break;
+		}
+		Append_Bytes_Len(buf, cp, ep - cp);
+		cp = ep + 1;
+		if (cp == end && (csv->flags & CSV_MORE)) return 0; // (may be "")
+		if (cp < end && *cp == '"') {
+			Append_Byte(buf, '"');
+			cp++;
+			continue;
+		}
+		// Closed; keep any text after it:
+		ep = Scan_CSV_Field(cp, end, csv->sep);
+		Append_Bytes_Len(buf, cp, ep - cp);
+		cp = ep;
+		break;
+	}
+
+	Set_String(val, Append_UTF8(0, BIN_HEAD(buf), SERIES_TAIL(buf)));
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Decode_CSV_Rows(REBCSV *csv, REBCNT *used)
+/*
+**		Returns a block of row blocks. Sets used to the length
+**		of the data decoded (less than all if CSV_MORE).
+**
+***********************************************************************/
+{
+	REBYTE *cp = csv->head;
+	REBYTE *end = csv->end;
+	REBYTE *row_head;
+	REBYTE *ep;
+	REBSER *rows;
+	REBSER *row;
+	REBVAL *val;
+	REBCNT cols = 8;
+
+	rows = Make_Block(64);
+	SAVE_SERIES(rows);
+
+	while (cp < end) {
+		// Skip blank lines:
+		if (*cp == CR || *cp == LF) {
+			cp++;
+			continue;
+		}
+
+		row_head = cp;
+		val = Append_Value(rows);
+		SET_NONE(val);
+		row = Make_Block(cols);
+		Set_Block(val, row);
+
+		// Each field of the row:
+		for (;;) {
+			val = Append_Value(row);
+			SET_NONE(val);
+			if (*cp == '"') {
+				if (!(cp = CSV_Quoted(csv, val, cp))) goto partial;
+			}
+			else {
+				ep = Scan_CSV_Field(cp, end, csv->sep);
+				CSV_Field(csv, val, cp, ep - cp);
+				cp = ep;
+			}
+
+			if (cp == end) {
+				if (csv->flags & CSV_MORE) goto partial;
+				break;
+			}
+			if (*cp == csv->sep) {
+				if (++cp < end) continue;
+				if (csv->flags & CSV_MORE) goto partial;
+				val = Append_Value(row); // empty last field
+				SET_NONE(val);
+				if (csv->flags & CSV_STRINGS) Set_String(val, Make_Binary(0));
+				break;
+			}
+			// Line end (CR, LF, or CR LF):
+			if (*cp++ == CR) {
+				if (cp == end && (csv->flags & CSV_MORE)) goto partial;
+				if (cp < end && *cp == LF) cp++;
+			}
+			break;
+		}
+		cols = SERIES_TAIL(row);
+	}
+
+	*used = cp - csv->head;
+	UNSAVE_SERIES(rows);
+	return rows;
+
+partial:
+	// The last row is not all there yet:
+	SERIES_TAIL(rows)--;
+	SET_END(BLK_TAIL(rows));
+	*used = row_head - csv->head;
+	UNSAVE_SERIES(rows);
+	return rows;
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *CSV_Columns(REBSER *rows)
+/*
+**		Turn a block of rows into a block of columns. A column of
+**		integers becomes a 64 bit integer vector; of numbers, a 64
+**		bit decimal vector; other columns are blocks.
+**
+***********************************************************************/
+{
+	REBCNT nrows = SERIES_TAIL(rows);
+	REBCNT ncols = 0;
+	REBSER *out;
+	REBSER *ser;
+	REBVAL *row;
+	REBVAL *val;
+	REBVAL *col;
+	REBCNT c, r;
+	REBCNT type;
+
+	SAVE_SERIES(rows);
+
+	for (r = 0; r < nrows; r++)
+		ncols = MAX(ncols, VAL_LEN(BLK_SKIP(rows, r)));
+
+	out = Make_Block(ncols);
+	SAVE_SERIES(out);
+
+	for (c = 0; c < ncols; c++) {
+		col = Append_Value(out);
+		SET_NONE(col);
+
+		// Integers, decimals, or other values?
+		type = REB_INTEGER;
+		for (r = 0; r < nrows && type != REB_BLOCK; r++) {
+			row = BLK_SKIP(rows, r);
+			val = (c < VAL_LEN(row)) ? VAL_BLK_SKIP(row, c) : 0;
+			if (val && IS_DECIMAL(val)) type = REB_DECIMAL;
+			else if (!val || !IS_INTEGER(val)) type = REB_BLOCK;
+		}
+
+		if (type == REB_BLOCK) {
+			ser = Make_Block(nrows);
+			Set_Block(col, ser);
+			for (r = 0; r < nrows; r++) {
+				row = BLK_SKIP(rows, r);
+				val = Append_Value(ser);
+				if (c < VAL_LEN(row)) *val = *VAL_BLK_SKIP(row, c);
+				else SET_NONE(val);
+			}
+		}
+		else {
+			ser = Make_Vector(type == REB_DECIMAL, 0, 1, 64, nrows);
+			SET_TYPE(col, REB_VECTOR);
+			VAL_SERIES(col) = ser;
+			VAL_INDEX(col) = 0;
+			for (r = 0; r < nrows; r++) {
+				val = VAL_BLK_SKIP(BLK_SKIP(rows, r), c);
+				if (type == REB_INTEGER) ((REBI64 *)ser->data)[r] = VAL_INT64(val);
+				else ((REBDEC *)ser->data)[r] = IS_INTEGER(val) ? (REBDEC)VAL_INT64(val) : VAL_DECIMAL(val);
+			}
+		}
+	}
+
+	UNSAVE_SERIES(out);
+	UNSAVE_SERIES(rows);
+	return out;
+}
+
+
+/***********************************************************************
+**
+*/	static void Encode_CSV_Field(REBCSV *csv, REBSER *out, REBVAL *val)
+/*
+**		Append a field as UTF-8, in quotes if it needs them.
+**
+***********************************************************************/
+{
+	REBSER *ser = 0;
+	REBSER *utf;
+	REBVAL tmp;
+	REBYTE *bp;
+	REBYTE *ep;
+	REBYTE *qp;
+
+	if (IS_NONE(val)) return;
+
+	if (!ANY_STR(val)) {
+		ser = Copy_Form_Value(val, 0);
+		SAVE_SERIES(ser);
+		Set_String(&tmp, ser);
+		val = &tmp;
+	}
+
+	// As UTF-8 (ASCII is used as-is):
+	utf = Encode_UTF8_Value(val, VAL_LEN(val), 1 << ENC_OPT_NO_COPY);
+	if (utf) {
+		SAVE_SERIES(utf);
+		bp = BIN_HEAD(utf);
+		ep = bp + SERIES_TAIL(utf);
+	}
+	else {
+		bp = VAL_BIN_DATA(val);
+		ep = bp + VAL_LEN(val);
+	}
+
+	if (Scan_CSV_Field(bp, ep, csv->sep) == ep && !memchr(bp, '"', ep - bp)) {
+		Append_Bytes_Len(out, bp, ep - bp);
+	}
+	else {
+		// Quote it, doubling its quotes:
+		Append_Byte(out, '"');
+		while ((qp = memchr(bp, '"', ep - bp))) {
+			Append_Bytes_Len(out, bp, qp + 1 - bp);
+			Append_Byte(out, '"');
+			bp = qp + 1;
+		}
+		Append_Bytes_Len(out, bp, ep - bp);
+		Append_Byte(out, '"');
+	}
+
+	if (utf) {UNSAVE_SERIES(utf);}
+	if (ser) {UNSAVE_SERIES(ser);}
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Encode_CSV_Rows(REBCSV *csv, REBVAL *data)
+/*
+**		Each value of the block is a row block (or one field).
+**
+***********************************************************************/
+{
+	REBSER *out = Make_Binary(VAL_LEN(data) * 32);
+	REBVAL *row;
+	REBVAL *val;
+	REBVAL *end;
+
+	SAVE_SERIES(out);
+
+	for (row = VAL_BLK_DATA(data); NOT_END(row); row++) {
+		if (ANY_BLOCK(row)) val = VAL_BLK_DATA(row), end = VAL_BLK_TAIL(row);
+		else val = row, end = row + 1;
+		for (; val < end; val++) {
+			Encode_CSV_Field(csv, out, val);
+			if (val + 1 < end) Append_Byte(out, csv->sep);
+		}
+		Append_Bytes_Len(out, (REBYTE *)"\r\n", 2);
+	}
+
+	UNSAVE_SERIES(out);
+	return out;
+}
+
+
+/***********************************************************************
+**
+*/	REBINT Codec_CSV(REBCDI *codi)
+/*
+***********************************************************************/
+{
+	REBCSV csv;
+	REBSER *ser;
+	REBCNT used;
+
+	codi->error = 0;
+	CSV_Options(&csv, (REBVAL *)codi->opts);
+
+	if (codi->action == CODI_IDENTIFY) {
+		codi->error = CODI_ERR_SIGNATURE; // (CSV has none)
+		return CODI_CHECK;
+	}
+
+	if (codi->action == CODI_DECODE) {
+		csv.head = codi->data;
+		csv.end = codi->data + codi->len;
+		if (What_UTF(csv.head, codi->len) == 8) csv.head += 3; // BOM
+		csv.buf = Make_Binary(256);
+		SAVE_SERIES(csv.buf);
+		ser = Decode_CSV_Rows(&csv, &used);
+		if (csv.flags & CSV_COLUMNS) ser = CSV_Columns(ser);
+		UNSAVE_SERIES(csv.buf);
+		codi->other = ser;
+		codi->len = csv.head + used - codi->data;
+		return CODI_BLOCK;
+	}
+
+	if (codi->action == CODI_ENCODE) {
+		if (!codi->block || !IS_BLOCK((REBVAL *)codi->block)) {
+			codi->error = CODI_ERR_NA; // (rows are a block)
+			return CODI_ERROR;
+		}
+		ser = Encode_CSV_Rows(&csv, (REBVAL *)codi->block);
+		codi->len = SERIES_TAIL(ser);
+		codi->data = Make_Mem(codi->len);
+		memcpy(codi->data, BIN_HEAD(ser), codi->len);
+		return CODI_BINARY;
+	}
+
+	codi->error = CODI_ERR_NA;
+	return CODI_ERROR;
+}
+
+
+/***********************************************************************
+**
+*/	void Init_CSV_Codec(void)
+/*
+***********************************************************************/
+{
+	Register_Codec("csv", Codec_CSV);
+}
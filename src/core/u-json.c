@@ -0,0 +1,869 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  u-json.c
+**  Summary: JSON data conversion
+**  Section: utility
+**  Notes:
+**    Decodes JSON text (RFC 8259, UTF-8) and encodes values back:
+**
+**        object    map! (or object! with the object option)
+**        array     block!
+**        string    string!
+**        number    integer! (if it fits and has no fraction or
+**                  exponent), else decimal!
+**        true      true, false (logic!)
+**        null      none
+**
+**    Object names that are words (a-z, digits, - _ ? ! .) become
+**    set-words of the map, others stay strings (and are an error
+**    with the object option). Note that a map has no entry for a
+**    none value, so null members are dropped.
+**    Encode also takes paren!, vector! (array), any word and char!
+**    (string); other values are formed as strings.
+**
+**    Decode returns a block of the values (for do-codec); DECODE
+**    returns the one value. Options (DECODE/options, ENCODE/options):
+**        object  - decode JSON objects to object!
+**        lines   - any number of values, one per line (JSON Lines)
+**        items   - the data is the inside of an array: the items
+**                  and their commas, up to and with the closing ]
+**                  (with more, the ] is left for the last pass)
+**        more    - the data continues: decode only whole values
+**                  (see REBCDI ->len; used by DECODE of a port)
+**
+**    Strings are scanned and copied 16 bytes at a time with SSE2
+**    (both ways), as is the white space between values.
+**
+***********************************************************************/
+
+#include "sys-core.h"
+#include "sys-simd.h"
+
+enum JSON_Flags {
+	JSON_OBJECT = 1,
+	JSON_LINES = 2,
+	JSON_ITEMS = 4,
+	JSON_MORE = 8,
+};
+
+#define JSON_MAX_DEPTH 512
+
+typedef struct reb_json {
+	REBYTE *end;		// of data
+	REBCNT flags;
+	REBCNT depth;		// of arrays and objects
+	REBFLG short_data;	// data ended inside a value
+	REBSER *buf;		// for strings with escapes; encoded output
+} REBJSON;
+
+
+/***********************************************************************
+**
+*/	static void JSON_Options(REBJSON *json, REBVAL *opts)
+/*
+***********************************************************************/
+{
+	REBVAL *val;
+
+	CLEAR(json, sizeof(REBJSON));
+	if (!opts) return;
+
+	for (val = VAL_BLK_DATA(opts); NOT_END(val); val++) {
+		if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_OBJECT)
+			json->flags |= JSON_OBJECT;
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_LINES)
+			json->flags |= JSON_LINES;
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_ITEMS)
+			json->flags |= JSON_ITEMS;
+		else if (IS_WORD(val) && VAL_WORD_CANON(val) == SYM_MORE)
+			json->flags |= JSON_MORE;
+		else
+			Trap_Arg(val);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *Skip_JSON_Space(REBYTE *cp, REBYTE *end)
+/*
+**		Return the first char that is not white space.
+**
+***********************************************************************/
+{
+#ifdef USE_SSE2
+	__m128i v;
+	unsigned int hits;
+
+	if (cp < end && *cp > ' ') return cp; // (most often)
+
+	// Runs of indentation:
+	for (; cp + 16 <= end; cp += 16) {
+		v = LOAD_16(cp);
+		hits = ~HIGH_BITS(_mm_or_si128(
+			_mm_or_si128(IS_CHR(v, ' '), IS_CHR(v, TAB)),
+			_mm_or_si128(IS_CHR(v, CR), IS_CHR(v, LF)))) & 0xFFFF;
+		if (hits) return cp + Lowest_Bit(hits);
+	}
+#endif
+	for (; cp < end; cp++)
+		if (*cp != ' ' && *cp != TAB && *cp != CR && *cp != LF) break;
+
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *Scan_JSON_String(REBYTE *cp, REBYTE *end)
+/*
+**		Return the first char of a string that is not itself:
+**		a quote, a backslash, a control char, or the end.
+**
+***********************************************************************/
+{
+#ifdef USE_SSE2
+	__m128i ctl = SPLAT(0x1F);
+	__m128i v;
+	unsigned int hits;
+
+	for (; cp + 16 <= end; cp += 16) {
+		v = LOAD_16(cp);
+		hits = HIGH_BITS(_mm_or_si128(
+			_mm_or_si128(IS_CHR(v, '"'), IS_CHR(v, '\\')),
+			_mm_cmpeq_epi8(_mm_max_epu8(v, ctl), ctl))); // (unsigned v <= 1F)
+		if (hits) return cp + Lowest_Bit(hits);
+	}
+#endif
+	for (; cp < end; cp++)
+		if (*cp == '"' || *cp == '\\' || *cp < 0x20) break;
+
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Short(REBJSON *json)
+/*
+**		The data ended before the value did. Returns 0 (failed).
+**
+***********************************************************************/
+{
+	json->short_data = TRUE;
+	return 0;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Hex4(REBJSON *json, REBYTE *cp, REBCNT *chr)
+/*
+**		Get the four hex digits of a \u escape.
+**
+***********************************************************************/
+{
+	REBCNT n = 0;
+	REBINT i;
+	REBYTE c;
+
+	if (json->end - cp < 4) return JSON_Short(json);
+
+	for (i = 0; i < 4; i++) {
+		c = *cp++;
+		if (c >= '0' && c <= '9') c -= '0';
+		else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') c = (c | 0x20) - 'a' + 10;
+		else return 0;
+		n = (n << 4) + c;
+	}
+
+	*chr = n;
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Chars(REBJSON *json, REBYTE *cp, REBYTE **bp, REBCNT *len)
+/*
+**		Get the UTF-8 chars of a string at its opening quote.
+**		Without escapes they are used in place, else they are
+**		put in the buffer. Returns the end of the string.
+**
+***********************************************************************/
+{
+	REBSER *buf = json->buf;
+	REBYTE *end = json->end;
+	REBYTE *ep;
+	REBYTE utf[4];
+	REBCNT chr;
+	REBCNT low;
+
+	ep = Scan_JSON_String(++cp, end);
+	if (ep < end && *ep == '"') {
+		*bp = cp;
+		*len = ep - cp;
+		return ep + 1;
+	}
+
+	RESET_TAIL(buf);
+	for (;;) {
+		Append_Bytes_Len(buf, cp, ep - cp);
+		if (ep == end) return JSON_Short(json);
+		if (*ep == '"') break;
+		if (*ep < 0x20) return 0; // (must be escaped)
+		if (++ep == end) return JSON_Short(json);
+		switch (*ep++) {
+		case '"':
+		case '\\':
+		case '/':
+			Append_Byte(buf, ep[-1]);
+			break;
+		case 'b': Append_Byte(buf, '\b'); break;
+		case 'f': Append_Byte(buf, '\f'); break;
+		case 'n': Append_Byte(buf, LF); break;
+		case 'r': Append_Byte(buf, CR); break;
+		case 't': Append_Byte(buf, TAB); break;
+		case 'u':
+			if (!(ep = JSON_Hex4(json, ep, &chr))) return 0;
+			if (chr >= 0xD800 && chr < 0xDC00) {
+				// A surrogate pair is one char:
+				if (end - ep < 6 && (json->flags & JSON_MORE)) return JSON_Short(json);
+				if (end - ep >= 6 && ep[0] == '\\' && ep[1] == 'u' && JSON_Hex4(json, ep + 2, &low)
+					&& low >= 0xDC00 && low < 0xE000) {
+					chr = 0x10000 + ((chr - 0xD800) << 10) + (low - 0xDC00);
+					ep += 6;
+				}
+				else chr = 0xFFFD; // (not a pair)
+			}
+			else if (chr >= 0xDC00 && chr < 0xE000) chr = 0xFFFD;
+			Append_Bytes_Len(buf, utf, Encode_UTF8_Char(utf, chr));
+			break;
+		default:
+			return 0;
+		}
+		cp = ep;
+		ep = Scan_JSON_String(cp, end);
+	}
+
+	*bp = BIN_HEAD(buf);
+	*len = SERIES_TAIL(buf);
+	return ep + 1;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Number(REBJSON *json, REBVAL *val, REBYTE *cp)
+/*
+**		Set an integer if the number has no fraction or exponent
+**		and fits in 64 bits, else a decimal.
+**
+***********************************************************************/
+{
+	REBYTE *bp = cp;
+	REBYTE *end = json->end;
+	REBYTE *dp;
+	REBU64 n = 0;
+	REBU64 max = (*cp == '-') ? (REBU64)MAX_I64 + 1 : (REBU64)MAX_I64;
+	REBCNT digits = 0;
+	REBFLG dec = FALSE;
+
+	if (*bp == '-') bp++;
+	if (bp < end && *bp == '0') bp++, digits++;
+	else {
+		for (; bp < end && *bp >= '0' && *bp <= '9'; bp++, digits++) {
+			if (n > (max - (*bp - '0')) / 10) dec = TRUE; // (overflow)
+			else n = n * 10 + (*bp - '0');
+		}
+	}
+	if (!digits) return (bp == end) ? JSON_Short(json) : 0;
+
+	if (bp < end && *bp == '.') {
+		dec = TRUE;
+		for (dp = ++bp; bp < end && *bp >= '0' && *bp <= '9'; bp++);
+		if (bp == dp) return (bp == end) ? JSON_Short(json) : 0;
+	}
+	if (bp < end && (*bp == 'e' || *bp == 'E')) {
+		dec = TRUE;
+		if (++bp < end && (*bp == '-' || *bp == '+')) bp++;
+		for (dp = bp; bp < end && *bp >= '0' && *bp <= '9'; bp++);
+		if (bp == dp) return (bp == end) ? JSON_Short(json) : 0;
+	}
+	if (bp == end && (json->flags & JSON_MORE)) return JSON_Short(json); // (may go on)
+
+	if (!dec) {
+		SET_INTEGER(val, (*cp == '-') ? (REBI64)(0 - n) : (REBI64)n);
+		return bp;
+	}
+	if (!Scan_Decimal(cp, bp - cp, val, TRUE)) return 0;
+	return bp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBFLG JSON_Is_Word(REBYTE *bp, REBCNT len)
+/*
+**		Is an object name one that reads back as the same word?
+**
+***********************************************************************/
+{
+	REBYTE *ep = bp + len;
+
+	if (!len || !(((*bp | 0x20) >= 'a' && (*bp | 0x20) <= 'z') || *bp == '_')) return FALSE;
+	for (bp++; bp < ep; bp++) {
+		if ((*bp >= 'a' && *bp <= 'z') || (*bp >= 'A' && *bp <= 'Z')
+			|| (*bp >= '0' && *bp <= '9')) continue;
+		if (*bp != '-' && *bp != '_' && *bp != '?' && *bp != '!' && *bp != '.') return FALSE;
+	}
+	return TRUE;
+}
+
+
+static REBYTE *JSON_Value(REBJSON *json, REBVAL *val, REBYTE *cp);
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Array(REBJSON *json, REBVAL *val, REBYTE *cp)
+/*
+***********************************************************************/
+{
+	REBYTE *end = json->end;
+	REBSER *blk = Make_Block(8);
+	REBVAL *item;
+
+	Set_Block(val, blk); // (GC safe from here)
+
+	cp = Skip_JSON_Space(cp + 1, end);
+	if (cp < end && *cp == ']') return cp + 1;
+
+	for (;;) {
+		item = Append_Value(blk);
+		SET_NONE(item);
+		if (!(cp = JSON_Value(json, item, cp))) return 0;
+		cp = Skip_JSON_Space(cp, end);
+		if (cp == end) return JSON_Short(json);
+		if (*cp == ']') return cp + 1;
+		if (*cp++ != ',') return 0;
+		cp = Skip_JSON_Space(cp, end);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void JSON_To_Object(REBVAL *val)
+/*
+**		Make an object of the name and value block of val.
+**		A name given twice keeps its last value.
+**
+***********************************************************************/
+{
+	REBSER *blk = VAL_SERIES(val);
+	REBSER *frame;
+	REBVAL *item;
+	REBCNT n;
+	REBCNT sym;
+
+	frame = Make_Frame(SERIES_TAIL(blk) / 2);
+	SAVE_SERIES(frame);
+
+	for (item = BLK_HEAD(blk); NOT_END(item); item += 2) {
+		sym = VAL_WORD_SYM(item);
+		if (!(n = Find_Word_Index(frame, sym, TRUE))) {
+			Append_Frame(frame, 0, sym);
+			n = SERIES_TAIL(frame) - 1;
+		}
+		*FRM_VALUE(frame, n) = item[1];
+	}
+
+	UNSAVE_SERIES(frame);
+	Set_Object(val, frame);
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Members(REBJSON *json, REBVAL *val, REBYTE *cp)
+/*
+**		Decode an object to a map (or object), via a block of
+**		names and values.
+**
+***********************************************************************/
+{
+	REBYTE *end = json->end;
+	REBSER *blk = Make_Block(16);
+	REBVAL *item;
+	REBYTE *bp;
+	REBCNT len;
+
+	Set_Block(val, blk);
+
+	cp = Skip_JSON_Space(cp + 1, end);
+	if (cp < end && *cp == '}') cp++;
+	else for (;;) {
+		// The name:
+		if (cp == end) return JSON_Short(json);
+		if (*cp != '"') return 0;
+		if (!(cp = JSON_Chars(json, cp, &bp, &len))) return 0;
+		item = Append_Value(blk);
+		SET_NONE(item);
+		if (JSON_Is_Word(bp, len)) {
+			Init_Word(item, Make_Word(bp, len));
+			VAL_SET(item, REB_SET_WORD);
+		}
+		else {
+			Set_String(item, Append_UTF8(0, bp, len));
+			if (json->flags & JSON_OBJECT) Trap_Arg(item); // (not a field name)
+		}
+		cp = Skip_JSON_Space(cp, end);
+		if (cp == end) return JSON_Short(json);
+		if (*cp++ != ':') return 0;
+
+		// The value:
+		item = Append_Value(blk);
+		SET_NONE(item);
+		if (!(cp = JSON_Value(json, item, Skip_JSON_Space(cp, end)))) return 0;
+		cp = Skip_JSON_Space(cp, end);
+		if (cp == end) return JSON_Short(json);
+		if (*cp == '}') {
+			cp++;
+			break;
+		}
+		if (*cp++ != ',') return 0;
+		cp = Skip_JSON_Space(cp, end);
+	}
+
+	if (json->flags & JSON_OBJECT) JSON_To_Object(val);
+	else {
+		Block_As_Map(blk);
+		Set_Series(REB_MAP, val, blk);
+	}
+	return cp;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Literal(REBJSON *json, REBYTE *cp, char *word)
+/*
+***********************************************************************/
+{
+	REBCNT len = LEN_BYTES(word);
+	REBCNT n = MIN(len, (REBCNT)(json->end - cp));
+
+	if (memcmp(cp, word, n)) return 0;
+	if (n < len) return JSON_Short(json);
+	return cp + len;
+}
+
+
+/***********************************************************************
+**
+*/	static REBYTE *JSON_Value(REBJSON *json, REBVAL *val, REBYTE *cp)
+/*
+**		Decode the value at cp into val. Returns the end of it,
+**		or 0 if it is not valid or not all there (short_data).
+**
+***********************************************************************/
+{
+	REBYTE *bp;
+	REBCNT len;
+
+	if (cp == json->end) return JSON_Short(json);
+
+	switch (*cp) {
+
+	case '{':
+	case '[':
+		if (++json->depth > JSON_MAX_DEPTH) Trap0(RE_STACK_OVERFLOW);
+		cp = (*cp == '{') ? JSON_Members(json, val, cp) : JSON_Array(json, val, cp);
+		json->depth--;
+		return cp;
+
+	case '"':
+		if (!(cp = JSON_Chars(json, cp, &bp, &len))) return 0;
+		Set_String(val, Append_UTF8(0, bp, len));
+		return cp;
+
+	case 't':
+		if ((cp = JSON_Literal(json, cp, "true"))) SET_TRUE(val);
+		return cp;
+
+	case 'f':
+		if ((cp = JSON_Literal(json, cp, "false"))) SET_FALSE(val);
+		return cp;
+
+	case 'n':
+		return JSON_Literal(json, cp, "null"); // (val is none)
+	}
+
+	return JSON_Number(json, val, cp);
+}
+
+
+/***********************************************************************
+**
+*/	static REBSER *Decode_JSON(REBJSON *json, REBYTE *cp, REBCNT *used)
+/*
+**		Returns a block of the values, or 0 if the data is not
+**		valid JSON. Sets used to the length of the data decoded
+**		(less than all if JSON_MORE).
+**
+***********************************************************************/
+{
+	REBYTE *head = cp;
+	REBYTE *end = json->end;
+	REBYTE *val_head;
+	REBSER *out;
+	REBVAL *val;
+	REBFLG closed = FALSE;	// saw the ] of JSON_ITEMS
+
+	out = Make_Block((json->flags & (JSON_LINES | JSON_ITEMS)) ? 64 : 1);
+	SAVE_SERIES(out);
+
+	while ((cp = Skip_JSON_Space(cp, end)) < end) {
+		if ((json->flags & JSON_ITEMS) && *cp == ']') {
+			// The end of the array (a trailing comma is let pass).
+			// It is left for the last pass, which must see it:
+			if (json->flags & JSON_MORE) break;
+			if (Skip_JSON_Space(cp + 1, end) != end) goto bad;
+			closed = TRUE;
+			cp = end;
+			break;
+		}
+		if (SERIES_TAIL(out) && !(json->flags & (JSON_LINES | JSON_ITEMS)))
+			goto bad; // only one value
+
+		val_head = cp;
+		val = Append_Value(out);
+		SET_NONE(val);
+		if (!(cp = JSON_Value(json, val, cp))) {
+			if (json->short_data && (json->flags & JSON_MORE)) goto partial;
+			goto bad;
+		}
+
+		cp = Skip_JSON_Space(cp, end);
+		if (cp == end) {
+			if (json->flags & JSON_MORE) goto partial; // (need the next char)
+			if (json->flags & JSON_ITEMS) goto bad; // (no closing bracket)
+		}
+		else if (json->flags & JSON_ITEMS) {
+			if (*cp == ',') cp++;
+			else if (*cp != ']') goto bad;
+		}
+	}
+
+	if (!SERIES_TAIL(out) && !(json->flags & (JSON_LINES | JSON_ITEMS | JSON_MORE)))
+		goto bad; // no value
+	if ((json->flags & (JSON_ITEMS | JSON_MORE)) == JSON_ITEMS && !closed)
+		goto bad; // the array was cut off
+
+	*used = cp - head;
+	UNSAVE_SERIES(out);
+	return out;
+
+partial:
+	// The last value is not all there yet:
+	SERIES_TAIL(out)--;
+	SET_END(BLK_TAIL(out));
+	*used = val_head - head;
+	UNSAVE_SERIES(out);
+	return out;
+
+bad:
+	UNSAVE_SERIES(out);
+	return 0;
+}
+
+
+/***********************************************************************
+**
+*/	static void Emit_JSON_Chars(REBSER *out, REBYTE *bp, REBYTE *ep)
+/*
+**		Append UTF-8 chars as a JSON string, with the escapes
+**		it needs. Runs with none are copied whole.
+**
+***********************************************************************/
+{
+	REBYTE *cp;
+	REBYTE esc[6];
+
+	Append_Byte(out, '"');
+
+	for (;;) {
+		cp = Scan_JSON_String(bp, ep);
+		Append_Bytes_Len(out, bp, cp - bp);
+		if (cp == ep) break;
+		esc[0] = '\\';
+		switch (*cp) {
+		case '"':
+		case '\\': esc[1] = *cp; break;
+		case '\b': esc[1] = 'b'; break;
+		case '\f': esc[1] = 'f'; break;
+		case LF:   esc[1] = 'n'; break;
+		case CR:   esc[1] = 'r'; break;
+		case TAB:  esc[1] = 't'; break;
+		default:
+			esc[1] = 'u';
+			esc[2] = esc[3] = '0';
+			esc[4] = Hex_Digits[*cp >> 4];
+			esc[5] = Hex_Digits[*cp & 0xF];
+			Append_Bytes_Len(out, esc, 6);
+			bp = cp + 1;
+			continue;
+		}
+		Append_Bytes_Len(out, esc, 2);
+		bp = cp + 1;
+	}
+
+	Append_Byte(out, '"');
+}
+
+
+/***********************************************************************
+**
+*/	static void Emit_JSON_String(REBSER *out, REBVAL *val)
+/*
+**		Append any string, word, char, or the form of any other
+**		value, as a JSON string.
+**
+***********************************************************************/
+{
+	REBSER *ser = 0;
+	REBSER *utf;
+	REBVAL tmp;
+	REBYTE *bp;
+	REBYTE buf[8];
+
+	if (ANY_WORD(val)) {
+		bp = Get_Word_Name(val);
+		Emit_JSON_Chars(out, bp, bp + LEN_BYTES(bp));
+		return;
+	}
+
+	if (IS_CHAR(val)) {
+		Emit_JSON_Chars(out, buf, buf + Encode_UTF8_Char(buf, VAL_CHAR(val)));
+		return;
+	}
+
+	if (!ANY_STR(val)) {
+		ser = Copy_Form_Value(val, 0);
+		SAVE_SERIES(ser);
+		Set_String(&tmp, ser);
+		val = &tmp;
+	}
+
+	// As UTF-8 (ASCII is used as-is):
+	utf = Encode_UTF8_Value(val, VAL_LEN(val), 1 << ENC_OPT_NO_COPY);
+	if (utf) Emit_JSON_Chars(out, BIN_HEAD(utf), BIN_SKIP(utf, SERIES_TAIL(utf)));
+	else Emit_JSON_Chars(out, VAL_BIN_DATA(val), VAL_BIN_DATA(val) + VAL_LEN(val));
+
+	if (ser) {UNSAVE_SERIES(ser);}
+}
+
+
+/***********************************************************************
+**
+*/	static void Emit_JSON_Number(REBSER *out, REBVAL *val)
+/*
+***********************************************************************/
+{
+	REBYTE buf[MAX_NUMCHR];
+	REBDEC d;
+
+	if (IS_INTEGER(val)) {
+		Append_Bytes_Len(out, buf, Emit_Integer(buf, VAL_INT64(val)));
+		return;
+	}
+
+	d = VAL_DECIMAL(val); // (also percent)
+	if (d - d != 0.0) Append_Bytes_Len(out, (REBYTE *)"null", 4); // (NaN or infinite)
+	else Append_Bytes_Len(out, buf, Emit_Decimal(buf, d, 0, '.', MAX_DIGITS));
+}
+
+
+/***********************************************************************
+**
+*/	static void Encode_JSON_Value(REBJSON *json, REBVAL *val)
+/*
+***********************************************************************/
+{
+	REBSER *out = json->buf;
+	REBVAL *item;
+	REBVAL *word;
+	REBVAL tmp;
+	REBCNT n;
+	REBFLG first = TRUE;
+
+	switch (VAL_TYPE(val)) {
+
+	case REB_NONE:
+		Append_Bytes_Len(out, (REBYTE *)"null", 4);
+		return;
+
+	case REB_LOGIC:
+		if (VAL_LOGIC(val)) Append_Bytes_Len(out, (REBYTE *)"true", 4);
+		else Append_Bytes_Len(out, (REBYTE *)"false", 5);
+		return;
+
+	case REB_INTEGER:
+	case REB_DECIMAL:
+	case REB_PERCENT:
+		Emit_JSON_Number(out, val);
+		return;
+
+	case REB_BLOCK:
+	case REB_PAREN:
+	case REB_VECTOR:
+	case REB_MAP:
+	case REB_OBJECT:
+		if (++json->depth > JSON_MAX_DEPTH) Trap0(RE_STACK_OVERFLOW); // (cyclic?)
+		break;
+
+	default:
+		Emit_JSON_String(out, val);
+		return;
+	}
+
+	if (IS_BLOCK(val) || IS_PAREN(val)) {
+		Append_Byte(out, '[');
+		for (item = VAL_BLK_DATA(val); NOT_END(item); item++) {
+			if (item != VAL_BLK_DATA(val)) Append_Byte(out, ',');
+			Encode_JSON_Value(json, item);
+		}
+		Append_Byte(out, ']');
+	}
+	else if (IS_VECTOR(val)) {
+		Append_Byte(out, '[');
+		for (n = VAL_INDEX(val); n < VAL_TAIL(val); n++) {
+			if (n != VAL_INDEX(val)) Append_Byte(out, ',');
+			Set_Vector_Value(&tmp, VAL_SERIES(val), n);
+			Emit_JSON_Number(out, &tmp);
+		}
+		Append_Byte(out, ']');
+	}
+	else if (IS_MAP(val)) {
+		// Names and values (no entry if none):
+		Append_Byte(out, '{');
+		for (item = BLK_HEAD(VAL_SERIES(val)); NOT_END(item) && NOT_END(item+1); item += 2) {
+			if (IS_NONE(item+1)) continue;
+			if (!first) Append_Byte(out, ',');
+			first = FALSE;
+			Emit_JSON_String(out, item);
+			Append_Byte(out, ':');
+			Encode_JSON_Value(json, item+1);
+		}
+		Append_Byte(out, '}');
+	}
+	else {
+		// Object words and values (not hidden, unset, or functions):
+		Append_Byte(out, '{');
+		word = FRM_WORDS(VAL_OBJ_FRAME(val)) + 1;
+		for (item = VAL_OBJ_VALUES(val) + 1; NOT_END(item); item++, word++) {
+			if (VAL_GET_OPT(word, OPTS_HIDE) || IS_UNSET(item) || ANY_FUNC(item)) continue;
+			if (!first) Append_Byte(out, ',');
+			first = FALSE;
+			Emit_JSON_String(out, word);
+			Append_Byte(out, ':');
+			Encode_JSON_Value(json, item);
+		}
+		Append_Byte(out, '}');
+	}
+
+	json->depth--;
+}
+
+
+/***********************************************************************
+**
+*/	REBINT Codec_JSON(REBCDI *codi)
+/*
+***********************************************************************/
+{
+	REBJSON json;
+	REBSER *ser;
+	REBVAL *val;
+	REBYTE *cp;
+	REBCNT used;
+
+	codi->error = 0;
+	JSON_Options(&json, (REBVAL *)codi->opts);
+
+	if (codi->action == CODI_IDENTIFY) {
+		codi->error = CODI_ERR_SIGNATURE; // (JSON has none)
+		return CODI_CHECK;
+	}
+
+	if (codi->action == CODI_DECODE) {
+		cp = codi->data;
+		json.end = codi->data + codi->len;
+		if (What_UTF(cp, codi->len) == 8) cp += 3; // BOM
+		json.buf = Make_Binary(256);
+		SAVE_SERIES(json.buf);
+		ser = Decode_JSON(&json, cp, &used);
+		UNSAVE_SERIES(json.buf);
+		if (!ser) {
+			codi->error = CODI_ERR_BAD_DATA;
+			return CODI_ERROR;
+		}
+		codi->other = ser;
+		codi->len = cp + used - codi->data;
+		return CODI_BLOCK;
+	}
+
+	if (codi->action == CODI_ENCODE) {
+		if (!codi->block) {
+			codi->error = CODI_ERR_NA; // (images have no JSON)
+			return CODI_ERROR;
+		}
+		val = (REBVAL *)codi->block;
+		json.buf = Make_Binary(256);
+		SAVE_SERIES(json.buf);
+		if ((json.flags & JSON_LINES) && IS_BLOCK(val)) {
+			for (val = VAL_BLK_DATA(val); NOT_END(val); val++) {
+				Encode_JSON_Value(&json, val);
+				Append_Byte(json.buf, LF);
+			}
+		}
+		else Encode_JSON_Value(&json, val);
+		UNSAVE_SERIES(json.buf);
+		codi->len = SERIES_TAIL(json.buf);
+		codi->data = Make_Mem(codi->len);
+		memcpy(codi->data, BIN_HEAD(json.buf), codi->len);
+		return CODI_BINARY;
+	}
+
+	codi->error = CODI_ERR_NA;
+	return CODI_ERROR;
+}
+
+
+/***********************************************************************
+**
+*/	void Init_JSON_Codec(void)
+/*
+***********************************************************************/
+{
+	Register_Codec("json", Codec_JSON);
+}
@@ -24,6 +24,32 @@
 **  Section: utility
 **  Author:  Carl Sassenrath
 **  Notes:
+**    Rule blocks are compiled on first use (see Get_Parse_Code)
+**    and the result is cached by the position of the block. The
+**    code holds the command of each word, where the next | is, and
+**    the variables of words, so they are not looked up again on
+**    each match or failure. It is trusted until Parse_Epoch moves,
+**    which happens whenever code is run (parens, paths, DO) or the
+**    parse sets a variable or modifies its input. The block is then
+**    compared with the copy it was compiled from before reuse.
+**
+**    PARSE/memo also remembers the result of each block sub-rule at
+**    each input index (packrat parsing), so backtracking does not
+**    retry it. A result is stored only if the epoch did not move
+**    while it ran (no actions, no changes), and is used only in the
+**    same epoch. The table is fixed in size; new results replace old.
+**
+**    For string input, a block of many alternatives that begin with
+**    literal strings or chars also gets a first char dispatch table
+**    (see Next_Alternative), so only those that can match are tried.
+**
+**    PARSE of an open port (file or TCP) reads the input in chunks
+**    into a binary buffer as rules need more of it (see Fill_Input).
+**    When the top rule block has no alternatives left and no SET,
+**    COPY, NOT, etc. is pending, no rule can go back before the
+**    current index, so the buffer is cut there (see Parse_Rules_Loop).
+**    Input positions kept by word: rules become invalid when that
+**    happens, so keep them only within one record.
 **
 ***********************************************************************/
 
@@ -43,6 +69,8 @@ typedef struct reb_parse {
 	REBCNT flags;
 	REBINT result;
 	REBVAL retval;
+	REBSER *stream;		// buffer of input read from a port, or 0
+	REBVAL source;		// the port (none at its end)
 } REBPARSE;
 
 enum parse_flags {
@@ -60,16 +88,79 @@ enum parse_flags {
 };
 
 #define MAX_PARSE_DEPTH 512
+#define PARSE_CHUNK 0x10000	// bytes read from a port at a time
+
+typedef struct reb_parse_op {
+	REBCNT cmd;			// PARSE command symbol of a word, or 0
+	REBCNT bar;			// index of the next | at or after this rule, or end
+	REBI64 epoch;		// when var was fetched
+	REBVAL *var;		// variable of a word rule
+} PARSE_OP;
+
+typedef struct reb_parse_code {
+	struct reb_parse_code *next; // in cache bucket (or retired list)
+	REBVAL *head;		// the rule block it was compiled from
+	REBCNT len;			// rules (not counting the end)
+	REBCNT size;		// bytes allocated
+	REBI64 epoch;		// when last known to match the rules
+	REBVAL *copy;		// rules as they were compiled
+	REBCNT *disp;		// first char dispatch, or 0 (see Compile_Dispatch)
+	PARSE_OP ops[1];	// per rule, and one for the end
+} PARSE_CODE;
+
+#define PARSE_CACHE_SIZE 256	// buckets (power of 2)
+#define PARSE_CACHE_MAX 4096	// rule blocks kept between PARSE calls
+#define DISPATCH_MIN 4			// alternatives with a first char
+#define DISPATCH_OTHERS 8		// most other alternatives (in every list)
+#define DISPATCH_END 128		// list for the end of input (ASCII before it)
+#define PARSE_CODE_SIZE(n) (sizeof(PARSE_CODE) + (n) * sizeof(PARSE_OP) + (n) * sizeof(REBVAL))
+#define PARSE_HASH(h) ((((REBUPT)(h) >> 4) ^ ((REBUPT)(h) >> 12)) & (PARSE_CACHE_SIZE - 1))
+
+static PARSE_CODE *Parse_Cache[PARSE_CACHE_SIZE];
+static PARSE_CODE *Parse_Retired;	// replaced, but may still be in use
+static REBCNT Parse_Cached;			// rule blocks in the cache
+static REBCNT Parse_Depth;			// PARSE calls in progress
+static REBI64 Parse_Epoch = 1;		// moves when rules may have changed
+
+typedef struct reb_parse_memo {
+	REBVAL *rules;		// sub-rule block
+	REBSER *series;		// input
+	REBCNT index;		// where it was tried
+	REBCNT result;		// index after the match, or NOT_FOUND
+	REBI64 epoch;		// when it was stored
+} PARSE_MEMO;
+
+typedef struct reb_memo_table {
+	REBCNT mask;		// slots - 1 (power of 2)
+	PARSE_MEMO slots[1];
+} MEMO_TABLE;
+
+#define MEMO_MIN 1024		// slots
+#define MEMO_MAX 65536
+#define MEMO_TABLE_SIZE(n) (sizeof(MEMO_TABLE) + ((n) - 1) * sizeof(PARSE_MEMO))
+#define MEMO_HASH(r, i) ((((REBCNT)(REBUPT)(r) >> 4) ^ ((i) * 0x9E3779B1)) & Parse_Memo->mask)
+
+static MEMO_TABLE *Parse_Memo;		// of the current PARSE/memo, else 0
+
+#define RULES_MAY_CHANGE (Parse_Epoch++)
+#define DO_PAREN(v) (RULES_MAY_CHANGE, Do_Block_Value_Throw(v))
+// Recheck the code of a rule block if the epoch moved:
+#define CHECK_CODE(c) if ((c)->epoch != Parse_Epoch) (c) = Get_Parse_Code((c)->head)
+#define RULE_OP(c, r) ((c)->ops[(r) - (c)->head])
+// Make sure streamed input holds n bytes, when the port has them:
+#define IS_STREAM(p) ((p)->series == (p)->stream)
+#define NEED_INPUT(p, n) if (IS_STREAM(p) && (p)->series->tail < (n) && IS_PORT(&(p)->source)) Fill_Input(p, n)
 
 // Returns SYMBOL or 0 if not a command:
 #define GET_CMD(n) (((n) >= SYM_OR_BAR && (n) <= SYM_END) ? (n) : 0)
 #define VAL_CMD(v) GET_CMD(VAL_WORD_CANON(v))
 #define HAS_CASE(p) (p->flags & AM_FIND_CASE)
 #define IS_OR_BAR(v) (IS_WORD(v) && VAL_WORD_CANON(v) == SYM_OR_BAR)
-#define SKIP_TO_BAR(r) while (NOT_END(r) && !IS_SAME_WORD(r, SYM_OR_BAR)) r++;
+#define SKIP_TO_BAR(c, r) {CHECK_CODE(c); r = (c)->head + ((r) < (c)->head + (c)->len ? RULE_OP(c, r).bar : (c)->len);}
 #define IS_BLOCK_INPUT(p) (p->type >= REB_BLOCK)
 
 static REBCNT Parse_Rules_Loop(REBPARSE *parse, REBCNT index, REBVAL *rules, REBCNT depth);
+static PARSE_CODE *Get_Parse_Code(REBVAL *rules);
 
 void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 {
@@ -80,6 +171,322 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 }
 
 
+/***********************************************************************
+**
+*/	static REBCNT First_Char(REBVAL *item)
+/*
+**		Return the char (upper case) that a rule item must match
+**		first, if it is a literal that starts with an ASCII char.
+**		Otherwise, return NOT_FOUND.
+**
+***********************************************************************/
+{
+	REBCNT c = NOT_FOUND;
+
+	if (IS_CHAR(item)) c = VAL_CHAR(item);
+	else if ((IS_STRING(item) || IS_BINARY(item)) && VAL_LEN(item) > 0) c = VAL_ANY_CHAR(item);
+
+	return (c < 0x80) ? UP_CASE(c) : NOT_FOUND;
+}
+
+
+/***********************************************************************
+**
+*/	static void Compile_Dispatch(PARSE_CODE *code)
+/*
+**		Make the first char dispatch of the rules: for each ASCII
+**		char (upper case), and for the end of input, the list of
+**		alternatives that could match there, as rule indexes in
+**		order. An alternative that does not start with a literal
+**		is in every list.
+**
+**		Layout: disp[c] is where the list for c starts, and ends
+**		at disp[c+1]. The lists follow, from disp[DISPATCH_END+2].
+**
+***********************************************************************/
+{
+	REBCNT *disp = code->disp;
+	REBCNT m = DISPATCH_END + 2;
+	REBCNT c;
+	REBCNT n;
+	REBCNT first;
+
+	for (c = 0; c <= DISPATCH_END; c++) {
+		disp[c] = m;
+		for (n = 0; ; n = code->ops[n].bar + 1) {
+			first = First_Char(code->head + n);
+			if (first == NOT_FOUND || first == c) disp[m++] = n;
+			if (n == code->len || code->ops[n].bar == code->len) break;
+		}
+	}
+	disp[c] = m;
+}
+
+
+/***********************************************************************
+**
+*/	static PARSE_CODE *Compile_Rules(REBVAL *rules)
+/*
+**		Compile a rule block: the command of each word, the index
+**		of the next | from each rule, and a copy of the rules to
+**		detect changes.
+**
+***********************************************************************/
+{
+	PARSE_CODE *code;
+	REBCNT len;
+	REBCNT bar;
+	REBCNT n;
+	REBCNT known = 0;	// alternatives that start with a literal
+	REBCNT others = 0;
+	REBCNT size;
+
+	for (len = 0; ; len++) {
+		if (len == 0 || IS_OR_BAR(rules + len - 1)) {
+			if (First_Char(rules + len) != NOT_FOUND) known++;
+			else others++;
+		}
+		if (IS_END(rules + len)) break;
+	}
+
+	size = PARSE_CODE_SIZE(len);
+	if (known < DISPATCH_MIN || others > DISPATCH_OTHERS) known = others = 0;
+	else size += (DISPATCH_END + 2 + known + others * (DISPATCH_END + 1)) * sizeof(REBCNT);
+
+	code = Make_Mem(size);
+	if (!code) Trap0(RE_NO_MEMORY);
+	code->head = rules;
+	code->len = len;
+	code->size = size;
+	code->epoch = Parse_Epoch;
+	code->copy = (REBVAL *)(code->ops + len + 1);
+	memcpy(code->copy, rules, len * sizeof(REBVAL));
+
+	for (n = 0; n < len; n++) {
+		if (ANY_WORD(rules + n)) code->ops[n].cmd = VAL_CMD(rules + n);
+	}
+
+	// Where a failed alternative resumes, from each rule:
+	code->ops[len].bar = bar = len;
+	for (n = len; n > 0; n--) {
+		if (IS_OR_BAR(rules + n - 1)) bar = n - 1;
+		code->ops[n - 1].bar = bar;
+	}
+
+	if (known) {
+		code->disp = (REBCNT *)(code->copy + len);
+		Compile_Dispatch(code);
+	}
+
+	return code;
+}
+
+
+/***********************************************************************
+**
+*/	static PARSE_CODE *Get_Parse_Code(REBVAL *rules)
+/*
+**		Return the code for a rule block, from the cache if the
+**		block has not changed since it was compiled.
+**
+**		Code that is replaced is kept until the outer PARSE ends,
+**		as callers may still hold it (they recheck it before use).
+**
+***********************************************************************/
+{
+	PARSE_CODE **link = &Parse_Cache[PARSE_HASH(rules)];
+	PARSE_CODE *code;
+	REBCNT n;
+
+	for (code = *link; code; link = &code->next, code = code->next) {
+		if (code->head != rules) continue;
+		if (code->epoch == Parse_Epoch) return code;
+		for (n = 0; n < code->len; n++) {
+			// (An earlier end fails here, so never reads past it.)
+			if (memcmp(rules + n, code->copy + n, sizeof(REBVAL))) break;
+		}
+		if (n == code->len && IS_END(rules + n)) {
+			code->epoch = Parse_Epoch;
+			return code;
+		}
+		*link = code->next;
+		code->next = Parse_Retired;
+		Parse_Retired = code;
+		Parse_Cached--;
+		break;
+	}
+
+	code = Compile_Rules(rules);
+	link = &Parse_Cache[PARSE_HASH(rules)];
+	code->next = *link;
+	*link = code;
+	Parse_Cached++;
+
+	return code;
+}
+
+
+/***********************************************************************
+**
+*/	static REBVAL *Next_Alternative(REBPARSE *parse, PARSE_CODE *code, REBVAL *rules, REBCNT index)
+/*
+**		For rules with a first char dispatch, return the first
+**		alternative at or after rules that could match the input
+**		at index, or zero if none can. Other rules are returned
+**		as-is. The code must be current (CHECK_CODE).
+**
+***********************************************************************/
+{
+	REBCNT *disp = code->disp;
+	REBCNT pos = rules - code->head;
+	REBCNT c;
+	REBCNT n;
+
+	if (!disp || IS_BLOCK_INPUT(parse)) return rules;
+
+	if (index >= parse->series->tail) c = DISPATCH_END;
+	else {
+		c = GET_ANY_CHAR(parse->series, index);
+		if (c >= 0x80) return rules; // (case rules beyond ASCII vary)
+		c = UP_CASE(c);
+	}
+
+	for (n = disp[c]; n < disp[c + 1]; n++) {
+		if (disp[n] >= pos) return code->head + disp[n];
+	}
+	return 0;
+}
+
+
+/***********************************************************************
+**
+*/	static REBVAL *Get_Rule_Var(PARSE_CODE *code, REBVAL *word)
+/*
+**		Get_Var of a word in the rules. The variable is kept for
+**		the epoch, as only running code can move or rebind it.
+**		The code must be current (CHECK_CODE).
+**
+***********************************************************************/
+{
+	PARSE_OP *op = &RULE_OP(code, word);
+
+	if (op->epoch != Parse_Epoch) {
+		op->var = Get_Var(word);
+		op->epoch = Parse_Epoch;
+	}
+	return op->var;
+}
+
+
+/***********************************************************************
+**
+*/	static void Free_Parse_Codes(PARSE_CODE *code)
+/*
+***********************************************************************/
+{
+	PARSE_CODE *next;
+
+	for (; code; code = next) {
+		next = code->next;
+		Free_Mem(code, code->size);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static void End_Parse(void)
+/*
+**		Called as each PARSE returns or throws. When the outer one
+**		is done, frees retired code, and the cache if it has grown
+**		too large.
+**
+***********************************************************************/
+{
+	REBCNT n;
+
+	RULES_MAY_CHANGE; // for the code that runs next
+	if (--Parse_Depth > 0) return;
+
+	Free_Parse_Codes(Parse_Retired);
+	Parse_Retired = 0;
+
+	if (Parse_Cached > PARSE_CACHE_MAX) {
+		for (n = 0; n < PARSE_CACHE_SIZE; n++) {
+			Free_Parse_Codes(Parse_Cache[n]);
+			Parse_Cache[n] = 0;
+		}
+		Parse_Cached = 0;
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static MEMO_TABLE *Make_Memo_Table(REBCNT len)
+/*
+**		Make a memo table sized for an input length.
+**
+***********************************************************************/
+{
+	MEMO_TABLE *table;
+	REBCNT n;
+
+	for (n = MEMO_MIN; n < MEMO_MAX && n < len * 2; n *= 2);
+
+	table = Make_Mem(MEMO_TABLE_SIZE(n));
+	if (!table) Trap0(RE_NO_MEMORY);
+	table->mask = n - 1;
+
+	return table;
+}
+
+
+/***********************************************************************
+**
+*/	static void Free_Memo_Table(MEMO_TABLE *table)
+/*
+***********************************************************************/
+{
+	if (table) Free_Mem(table, MEMO_TABLE_SIZE(table->mask + 1));
+}
+
+
+/***********************************************************************
+**
+*/	static REBCNT Parse_Memo_Rules(REBPARSE *parse, REBCNT index, REBVAL *rules, REBCNT depth)
+/*
+**		Parse_Rules_Loop for a sub-rule block, using or storing
+**		its result in the memo table.
+**
+***********************************************************************/
+{
+	PARSE_MEMO *memo = &Parse_Memo->slots[MEMO_HASH(rules, index)];
+	REBI64 epoch = Parse_Epoch;
+	REBCNT result;
+
+	if (memo->epoch == epoch && memo->rules == rules
+		&& memo->index == index && memo->series == parse->series) {
+		PG_Reb_Stats->Parse_Memo_Hits++;
+		return memo->result;
+	}
+	PG_Reb_Stats->Parse_Memo_Misses++;
+
+	result = Parse_Rules_Loop(parse, index, rules, depth);
+
+	// Only if nothing ran or changed, and not ended by ACCEPT or REJECT:
+	if (Parse_Epoch == epoch && !parse->result) {
+		memo->rules = rules;
+		memo->series = parse->series;
+		memo->index = index;
+		memo->result = result;
+		memo->epoch = epoch;
+	}
+
+	return result;
+}
+
+
 /***********************************************************************
 **
 */	static REBCNT Parse_Series(REBVAL *val, REBVAL *rules, REBCNT flags, REBCNT depth)
@@ -92,11 +499,91 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 	parse.type = VAL_TYPE(val);
 	parse.flags = flags;
 	parse.result = 0;
+	parse.stream = 0;
 
 	return Parse_Rules_Loop(&parse, VAL_INDEX(val), rules, depth);
 }
 
 
+/***********************************************************************
+**
+*/	static void Fill_Input(REBPARSE *parse, REBCNT need)
+/*
+**		Read from the port until the input holds need bytes (or
+**		all of it for NOT_FOUND). At the end of the port, its
+**		value is set to none so it is not read again.
+**
+***********************************************************************/
+{
+	REBSER *buf = parse->stream;
+	REBVAL size;
+	REBVAL *val;
+
+	SET_INTEGER(&size, PARSE_CHUNK);
+	while (buf->tail < need && IS_PORT(&parse->source)) {
+		RULES_MAY_CHANGE; // (runs code)
+		val = Do_Sys_Func(SYS_CTX_READ_PARSE_CHUNK, &parse->source, &size, 0);
+		if (IS_BINARY(val) && VAL_LEN(val) > 0)
+			Append_Series(buf, VAL_BIN_DATA(val), VAL_LEN(val));
+		else
+			SET_NONE(&parse->source);
+	}
+}
+
+
+/***********************************************************************
+**
+*/	static REBFLG More_Input(REBPARSE *parse, REBCNT *index, REBCNT len)
+/*
+**		After a search of streamed input failed, read more of it.
+**		Moves the index to where a match of len could still start.
+**		Returns FALSE at the end of input (the search is done).
+**
+***********************************************************************/
+{
+	REBCNT tail = parse->series->tail;
+
+	if (!IS_STREAM(parse)) return FALSE;
+	NEED_INPUT(parse, tail + 1);
+	if (parse->series->tail == tail) return FALSE;
+	if (len == 0) len = 1;
+	if (tail + 1 > *index + len) *index = tail + 1 - len;
+	return TRUE;
+}
+
+
+/***********************************************************************
+**
+*/	static REBFLG Parse_Port(REBVAL *port, REBVAL *rules)
+/*
+**		Parse the input of an open port. Returns TRUE if the rules
+**		matched all of it.
+**
+***********************************************************************/
+{
+	REBPARSE parse;
+	REBSER *buf;
+	REBCNT n;
+
+	buf = Make_Binary(PARSE_CHUNK);
+	SAVE_SERIES(buf);
+	parse.series = parse.stream = buf;
+	parse.type = REB_BINARY;
+	parse.flags = AM_FIND_CASE;
+	parse.result = 0;
+	parse.source = *port;
+
+	n = Parse_Rules_Loop(&parse, 0, rules, 0);
+	if (n != NOT_FOUND) {
+		parse.series = buf; // (the rules may have moved to other input)
+		NEED_INPUT(&parse, n + 1);
+	}
+	UNSAVE_SERIES(buf);
+
+	return n != NOT_FOUND && n >= buf->tail;
+}
+
+
 /***********************************************************************
 **
 */	static REBCNT Set_Parse_Series(REBPARSE *parse, REBVAL *item)
@@ -127,6 +614,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 	}
 	else if (IS_PATH(item)) {
 		REBVAL *path = item;
+		RULES_MAY_CHANGE; // (may run parens)
 		if (Do_Path(&path, 0)) return item; // found a function
 		item = DS_TOP;
 	}
@@ -145,6 +633,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 	REBVAL *path = item;
 	REBVAL tmp;
 
+	RULES_MAY_CHANGE; // (may run parens, or set)
 	if (IS_PATH(item)) {
 		if (Do_Path(&path, 0)) return item; // found a function
 		item = DS_TOP;
@@ -193,6 +682,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 
 	if (IS_NONE(item)) return index;
 
+	NEED_INPUT(parse, index + 1);
 	if (index >= series->tail) return NOT_FOUND;
 
 	switch (VAL_TYPE(item)) {
@@ -208,6 +698,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 	case REB_EMAIL:
 	case REB_STRING:
 	case REB_BINARY: 
+		NEED_INPUT(parse, index + VAL_LEN(item));
 		index = Find_Str_Str(series, 0, index, SERIES_TAIL(series), 1, VAL_SERIES(item), VAL_INDEX(item), VAL_LEN(item), flags);
 		break;
 
@@ -230,6 +721,11 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 //	case REB_ISSUE:
 		// !! Can be optimized (w/o COPY)
 		ser = Copy_Form_Value(item, 0);
+		if (IS_STREAM(parse)) {
+			SAVE_SERIES(ser);
+			NEED_INPUT(parse, index + ser->tail);
+			UNSAVE_SERIES(ser);
+		}
 		index = Find_Str_Str(series, 0, index, SERIES_TAIL(series), 1, ser, 0, ser->tail, flags);
 		break;
 
@@ -243,7 +739,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 
 	// Do an expression:
 	case REB_PAREN:
-		item = Do_Block_Value_Throw(item); // might GC
+		item = DO_PAREN(item); // might GC
 		// old: if (IS_ERROR(item)) Throw_Error(VAL_ERR_OBJECT(item));
         index = MIN(index, series->tail); // may affect tail
 		break;
@@ -309,7 +805,7 @@ void Print_Parse_Index(REBCNT type, REBVAL *rules, REBSER *series, REBCNT index)
 
 	// Do an expression:
 	case REB_PAREN:
-		item = Do_Block_Value_Throw(item); // might GC
+		item = DO_PAREN(item); // might GC
 		// old: if (IS_ERROR(item)) Throw_Error(VAL_ERR_OBJECT(item));
         index = MIN(index, series->tail); // may affect tail
 		break;
@@ -340,16 +836,20 @@ no_result:
 	REBCNT cmd;
 	REBCNT i;
 	REBCNT len;
+	PARSE_CODE *code = Get_Parse_Code(VAL_BLK(block));
 
 	for (; index <= series->tail; index++) {
 
+		NEED_INPUT(parse, index + 1);
+
 		for (blk = VAL_BLK(block); NOT_END(blk); blk++) {
 
 			item = blk;
+			CHECK_CODE(code);
 
 			// Deal with words and commands
 			if (IS_WORD(item)) {
-				if (cmd = VAL_CMD(item)) {
+				if (cmd = RULE_OP(code, item).cmd) {
 					if (cmd == SYM_END) {
 						if (index >= series->tail) {
 							index = series->tail;
@@ -361,14 +861,14 @@ no_result:
 						item = ++blk; // next item is the quoted value
 						if (IS_END(item)) goto bad_target;
 						if (IS_PAREN(item)) {
-							item = Do_Block_Value_Throw(item); // might GC
+							item = DO_PAREN(item); // might GC
 						}
 
 					}
 					else goto bad_target;
 				}
 				else {
-					item = Get_Var(item);
+					item = Get_Rule_Var(code, item);
 				}
 			}
 			else if (IS_PATH(item)) {
@@ -397,6 +897,7 @@ no_result:
 					if (ch1 == *VAL_BIN_DATA(item)) {
 						len = VAL_LEN(item);
 						if (len == 1) goto found1;
+						NEED_INPUT(parse, index + len);
 						if (0 == Compare_Bytes(BIN_SKIP(series, index), VAL_BIN_DATA(item), len, 0)) {
 							if (is_thru) index += len;
 							goto found;
@@ -427,6 +928,7 @@ no_result:
 					if (ch1 == ch2) {
 						len = VAL_LEN(item);
 						if (len == 1) goto found1;
+						NEED_INPUT(parse, index + len);
 						i = Find_Str_Str(series, 0, index, SERIES_TAIL(series), 1, VAL_SERIES(item), VAL_INDEX(item), len, AM_FIND_MATCH | parse->flags);
 						if (i != NOT_FOUND) {
 							if (is_thru) i += len;
@@ -455,11 +957,11 @@ next:		// Check for | (required if not end)
 	return NOT_FOUND;
 
 found:
-	if (IS_PAREN(blk+1)) Do_Block_Value_Throw(blk+1);
+	if (IS_PAREN(blk+1)) DO_PAREN(blk+1);
 	return index;
 
 found1:
-	if (IS_PAREN(blk+1)) Do_Block_Value_Throw(blk+1);
+	if (IS_PAREN(blk+1)) DO_PAREN(blk+1);
 	return index + (is_thru ? 1 : 0);
 
 bad_target:
@@ -487,10 +989,12 @@ bad_target:
 	// TO a specific index position.
 	if (IS_INTEGER(item)) {
 		i = (REBCNT)Int32(item) - (is_thru ? 0 : 1);
+		NEED_INPUT(parse, i);
 		if (i > series->tail) i = series->tail;
 	}
 	// END
 	else if (IS_WORD(item) && VAL_WORD_CANON(item) == SYM_END) {
+		NEED_INPUT(parse, NOT_FOUND); // all of it
 		i = series->tail;
 	}
 	else if (IS_BLOCK(item)) {
@@ -509,27 +1013,35 @@ bad_target:
 			if (i != NOT_FOUND && is_thru) i++;
 		}
 		else {
+			REBCNT len = 1;
 			// "str"
 			if (ANY_BINSTR(item)) {
 				if (!IS_STRING(item) && !IS_BINARY(item)) {
 					// !!! Can this be optimized not to use COPY?
 					ser = Copy_Form_Value(item, 0);
-					i = Find_Str_Str(series, 0, index, series->tail, 1, ser, 0, ser->tail, HAS_CASE(parse));
-					if (i != NOT_FOUND && is_thru) i += ser->tail;
+					SAVE_SERIES(ser); // (streamed input runs code)
+					len = ser->tail;
+					do i = Find_Str_Str(series, 0, index, series->tail, 1, ser, 0, len, HAS_CASE(parse));
+					while (i == NOT_FOUND && More_Input(parse, &index, len));
+					UNSAVE_SERIES(ser);
 				}
 				else {
-					i = Find_Str_Str(series, 0, index, series->tail, 1, VAL_SERIES(item), VAL_INDEX(item), VAL_LEN(item), HAS_CASE(parse));
-					if (i != NOT_FOUND && is_thru) i += VAL_LEN(item);
+					len = VAL_LEN(item);
+					do i = Find_Str_Str(series, 0, index, series->tail, 1, VAL_SERIES(item), VAL_INDEX(item), len, HAS_CASE(parse));
+					while (i == NOT_FOUND && More_Input(parse, &index, len));
 				}
+				if (i != NOT_FOUND && is_thru) i += len;
 			}
 			// #"A"
 			else if (IS_CHAR(item)) {
-				i = Find_Str_Char(series, 0, index, series->tail, 1, VAL_CHAR(item), HAS_CASE(parse));
+				do i = Find_Str_Char(series, 0, index, series->tail, 1, VAL_CHAR(item), HAS_CASE(parse));
+				while (i == NOT_FOUND && More_Input(parse, &index, 1));
 				if (i != NOT_FOUND && is_thru) i++;
 			}
 			// bitset
 			else if (IS_BITSET(item)) {
-				i = Find_Str_Bitset(series, 0, index, series->tail, 1, VAL_BITSET(item), HAS_CASE(parse));
+				do i = Find_Str_Bitset(series, 0, index, series->tail, 1, VAL_BITSET(item), HAS_CASE(parse));
+				while (i == NOT_FOUND && More_Input(parse, &index, 1));
 				if (i != NOT_FOUND && is_thru) i++;
 			}
 		}
@@ -573,6 +1085,7 @@ bad_target:
 	}
 
 	// Evaluate next N input values:
+	RULES_MAY_CHANGE;
 	index = Do_Next(parse->series, index, FALSE);
 
 	// Value is on top of stack (volatile!):
@@ -592,7 +1105,7 @@ bad_target:
 			(*rule)++;
 			if (IS_END(item)) Trap1(RE_PARSE_END, item-2);
 			if (IS_PAREN(item)) {
-				item = Do_Block_Value_Throw(item); // might GC
+				item = DO_PAREN(item); // might GC
 			}
 		}
 		else if (n == SYM_INTO) {
@@ -627,6 +1140,7 @@ bad_target:
 	newparse.type = REB_BLOCK;
 	newparse.flags = parse->flags;
 	newparse.result = 0;
+	newparse.stream = 0;
 
 	n = (Parse_Next_Block(&newparse, 0, item, 0) != NOT_FOUND) ? index : NOT_FOUND;
 	UNSAVE_SERIES(newparse.series);
@@ -655,7 +1169,7 @@ bad_target:
 	REBSER *ser;
 	REBFLG flags;
 	REBCNT cmd;
-	REBVAL *rule_head = rules;
+	PARSE_CODE *code = Get_Parse_Code(rules);
 
 	CHECK_STACK(&flags);
 	//if (depth > MAX_PARSE_DEPTH) Trap_Word(RE_LIMIT_HIT, SYM_PARSE, 0);
@@ -664,12 +1178,16 @@ bad_target:
 	mincount = maxcount = 1;
 	start = begin = index;
 
+	// Skip alternatives that cannot match the first char:
+	if (code->disp && !(rules = Next_Alternative(parse, code, rules, index))) return NOT_FOUND;
+
 	// For each rule in the rule block:
 	while (NOT_END(rules)) {
 
 		//Print_Parse_Index(parse->type, rules, series, index);
 
 		if (--Eval_Count <= 0 || Eval_Signals) Do_Signals();
+		CHECK_CODE(code);
 
 		//--------------------------------------------------------------------
 		// Pre-Rule Processing Section
@@ -685,7 +1203,7 @@ bad_target:
 		if (VAL_TYPE(item) >= REB_WORD && VAL_TYPE(item) <= REB_GET_WORD) {
 
 			// Is it a command word?
-			if (cmd = VAL_CMD(item)) {
+			if (cmd = RULE_OP(code, item).cmd) {
 
 				if (!IS_WORD(item)) Trap1(RE_PARSE_COMMAND, item); // SET or GET not allowed
 
@@ -715,7 +1233,7 @@ bad_target:
 						SET_FLAG(flags, PF_SET_OR_COPY);
 						item = rules++;
 						if (!(IS_WORD(item) || IS_SET_WORD(item))) Trap1(RE_PARSE_VARIABLE, item);
-						if (VAL_CMD(item)) Trap1(RE_PARSE_COMMAND, item);
+						if (RULE_OP(code, item).cmd) Trap1(RE_PARSE_COMMAND, item);
 						word = item;
 						continue;
 
@@ -746,7 +1264,7 @@ bad_target:
 
 					case SYM_RETURN:
 						if (IS_PAREN(rules)) {
-							item = Do_Block_Value_Throw(rules); // might GC
+							item = DO_PAREN(rules); // might GC
 							Throw_Return_Value(item);
 						}
 						SET_FLAG(flags, PF_RETURN);
@@ -769,7 +1287,7 @@ bad_target:
 						item = rules++;
 						if (IS_END(item)) goto bad_end;
 						if (!IS_PAREN(item)) Trap1(RE_PARSE_RULE, item);
-						item = Do_Block_Value_Throw(item); // might GC
+						item = DO_PAREN(item); // might GC
 						if (IS_TRUE(item)) continue;
 						else {
 							index = NOT_FOUND;
@@ -800,6 +1318,7 @@ bad_target:
 					!(GET_FLAG(flags, PF_SET_OR_COPY) || GET_FLAG(flags, PF_COPY)))
 				{
 					Set_Var_Series(item, parse->type, series, index);
+					RULES_MAY_CHANGE;
 					continue;
 				}
 
@@ -812,12 +1331,13 @@ bad_target:
 					if (!ANY_SERIES(item)) Trap1(RE_PARSE_SERIES, rules-1);
 					index = Set_Parse_Series(parse, item);
 					series = parse->series;
+					RULES_MAY_CHANGE; // (input changed)
 					continue;
 				}
 
 				// word - some other variable
 				if (IS_WORD(item)) {
-					item = Get_Var(item);
+					item = Get_Rule_Var(code, item);
 				}
 
 				// item can still be 'word or /word
@@ -830,7 +1350,7 @@ bad_target:
 		}
 
 		if (IS_PAREN(item)) {
-			Do_Block_Value_Throw(item); // might GC
+			DO_PAREN(item); // might GC
 			if (index > series->tail) index = series->tail;
 			continue;
 		}
@@ -862,6 +1382,7 @@ bad_target:
 		begin = index;		// input at beginning of match section
 		rulen = 0;			// rules consumed (do not use rule++ below)
 		i = index;
+		if (IS_WORD(item)) cmd = VAL_WORD_CANON(item);
 
 		//note: rules var already advanced
 
@@ -871,13 +1392,15 @@ bad_target:
 
 			if (IS_WORD(item)) {
 
-				switch (cmd = VAL_WORD_CANON(item)) {
+				switch (cmd) {
 
 				case SYM_SKIP:
+					NEED_INPUT(parse, index + 1);
 					i = (index < series->tail) ? index+1 : NOT_FOUND;
 					break;
 
 				case SYM_END:
+					NEED_INPUT(parse, index + 1);
 					i = (index < series->tail) ? NOT_FOUND : series->tail;
 					break;
 
@@ -893,7 +1416,7 @@ bad_target:
 					if (IS_END(rules)) goto bad_end;
 					rulen = 1;
 					if (IS_PAREN(rules)) {
-						item = Do_Block_Value_Throw(rules); // might GC
+						item = DO_PAREN(rules); // might GC
 					}
 					else item = rules;
 					i = (0 == Cmp_Value(BLK_SKIP(series, index), item, parse->flags & AM_FIND_CASE)) ? index+1 : NOT_FOUND;
@@ -927,7 +1450,8 @@ bad_target:
 				//	rules = item;
 				//	goto top;
 				//}
-				i = Parse_Rules_Loop(parse, index, item, depth+1);
+				if (Parse_Memo) i = Parse_Memo_Rules(parse, index, item, depth+1);
+				else i = Parse_Rules_Loop(parse, index, item, depth+1);
 				if (parse->result) {
 					index = (parse->result > 0) ? i : NOT_FOUND;
 					parse->result = 0;
@@ -964,6 +1488,17 @@ bad_target:
 			}
 			index = i;
 
+			// Streamed input: drop what no rule can go back to.
+			if (depth == 0 && IS_STREAM(parse) && index >= PARSE_CHUNK && !(flags & ~(1<<PF_WHILE))) {
+				CHECK_CODE(code);
+				if (RULE_OP(code, rules).bar == code->len) {
+					Remove_Series(series, 0, index);
+					begin -= index;
+					index = i = start = 0;
+					RULES_MAY_CHANGE; // (memo positions moved)
+				}
+			}
+
 			// A BREAK word stopped us:
 			//if (parse->result) {parse->result = 0; break;}
 		}
@@ -987,12 +1522,14 @@ post:
 			if (index == NOT_FOUND) { // Failure actions:
 				// not decided: if (word) Set_Var_Basic(word, REB_NONE);
 				if (GET_FLAG(flags, PF_THEN)) {
-					SKIP_TO_BAR(rules);
+					SKIP_TO_BAR(code, rules);
 					if (!IS_END(rules)) rules++;
 				}
 			}
 			else {  // Success actions:
 				count = (begin > index) ? 0 : index - begin; // how much we advanced the input
+				// Variables set or input changed (may be the rules):
+				if (flags & (1<<PF_SET_OR_COPY | 1<<PF_REMOVE | 1<<PF_INSERT | 1<<PF_CHANGE)) RULES_MAY_CHANGE;
 				if (GET_FLAG(flags, PF_COPY)) {
 					ser = (IS_BLOCK_INPUT(parse))
 						? Copy_Block_Len(series, begin, count)
@@ -1033,8 +1570,9 @@ post:
 					cmd = GET_FLAG(flags, PF_INSERT) ? 0 : (1<<AN_PART);
 					item = rules++;
 					if (IS_END(item)) goto bad_end;
+					CHECK_CODE(code);
 					// Check for ONLY flag:
-					if (IS_WORD(item) && NZ(cmd = VAL_CMD(item))) {
+					if (IS_WORD(item) && NZ(cmd = RULE_OP(code, item).cmd)) {
 						if (cmd != SYM_ONLY) goto bad_rule;
 						cmd |= (1<<AN_ONLY);
 						item = rules++;
@@ -1063,10 +1601,14 @@ post:
 
 		// Goto alternate rule and reset input:
 		if (index == NOT_FOUND) {
-			SKIP_TO_BAR(rules);
+			SKIP_TO_BAR(code, rules);
 			if (IS_END(rules)) break;
 			rules++;
 			index = begin = start;
+			if (code->disp && !(rules = Next_Alternative(parse, code, rules, start))) {
+				index = NOT_FOUND;
+				break;
+			}
 		}
 
 		begin = index;
@@ -1222,6 +1764,39 @@ bad_end:
 }
 
 
+/***********************************************************************
+**
+*/	REBCNT Parse_Match(REBVAL *input, REBCNT index, REBVAL *rules)
+/*
+**		Match a rule block at an index of the input, as PARSE/all
+**		would (cased for binary). Returns the index past what was
+**		matched, or NOT_FOUND. For natives that take rules (SPLIT).
+**
+***********************************************************************/
+{
+	REBOL_STATE state;
+	REBVAL val = *input;
+	REBCNT n;
+
+	PUSH_STATE(state, Saved_State);
+	if (SET_JUMP(state)) {
+		POP_STATE(state, Saved_State);
+		End_Parse();
+		Catch_Error(DS_NEXT);
+		Throw_Break(DS_NEXT); // relay it
+	}
+	SET_STATE(state, Saved_State);
+	Parse_Depth++;
+	RULES_MAY_CHANGE;
+	VAL_INDEX(&val) = index;
+	n = Parse_Series(&val, VAL_BLK_DATA(rules), IS_BINARY(input) ? AM_FIND_CASE : 0, 0);
+	POP_STATE(state, Saved_State);
+	End_Parse();
+
+	return n;
+}
+
+
 /***********************************************************************
 **
 */	REBNATIVE(parse)
@@ -1245,15 +1820,21 @@ bad_end:
 		Set_Block(DS_RETURN, ser);
 	}
 	else if (IS_SAME_WORD(arg, SYM_TEXT)) {
+		if (IS_PORT(val)) Trap_Arg(val);
 		Set_Block(DS_RETURN, Parse_Lines(VAL_SERIES(val)));
 	}
 	else {
 		REBCNT n;
 		REBOL_STATE state;
+		MEMO_TABLE *outer = Parse_Memo; // (PARSE may be nested in a paren)
+		MEMO_TABLE *memo = D_REF(5) ? Make_Memo_Table(IS_PORT(val) ? PARSE_CHUNK : VAL_LEN(val)) : 0;
 		// Let user RETURN and THROW out of the PARSE. All other errors should relay.
 		PUSH_STATE(state, Saved_State);
 		if (SET_JUMP(state)) {
 			POP_STATE(state, Saved_State);
+			Parse_Memo = outer;
+			Free_Memo_Table(memo);
+			End_Parse();
 			Catch_Error(arg = DS_RETURN); // Stores error value here
 			if (VAL_ERR_NUM(arg) == RE_BREAK) {
 				if (!VAL_ERR_VALUE(arg)) return R_NONE;
@@ -1269,9 +1850,20 @@ bad_end:
 			Throw_Error(VAL_ERR_OBJECT(DS_RETURN));
 		}
 		SET_STATE(state, Saved_State);
-		n = Parse_Series(val, VAL_BLK_DATA(arg), (opts & PF_CASE) ? AM_FIND_CASE : 0, 0);
-		SET_LOGIC(DS_RETURN, n >= VAL_TAIL(val) && n != NOT_FOUND);
+		Parse_Depth++;
+		Parse_Memo = memo;
+		RULES_MAY_CHANGE; // since the last PARSE
+		if (IS_PORT(val)) {
+			SET_LOGIC(DS_RETURN, Parse_Port(val, VAL_BLK_DATA(arg)));
+		}
+		else {
+			n = Parse_Series(val, VAL_BLK_DATA(arg), (opts & PF_CASE) ? AM_FIND_CASE : 0, 0);
+			SET_LOGIC(DS_RETURN, n >= VAL_TAIL(val) && n != NOT_FOUND);
+		}
 		POP_STATE(state, Saved_State);
+		Parse_Memo = outer;
+		Free_Memo_Table(memo);
+		End_Parse();
 	}
 
 	return R_RET;
@@ -841,7 +841,7 @@ error:
 		return CODI_IMAGE;
 	}
 
-	if (codi->action == CODI_ENCODE) {
+	if (codi->action == CODI_ENCODE && codi->bits) { // (not for a block)
 		Encode_PNG_Image(codi);
 		return CODI_BINARY;
 	}
@@ -60,6 +60,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "sys-core.h"
+#include "sys-simd.h"
 
 #if !defined(ENDIAN_LITTLE) && !defined(ENDIAN_BIG)
 #error Endianness must be defined in rebol.h for builds including SHA1
@@ -298,6 +299,10 @@ unsigned long __builtin_rol(unsigned long,int,int);
      static void sha1_block(SHA_CTX *c, register unsigned long *p, int num);
 #  endif
 
+#ifdef USE_CPU_FLAGS
+static TARGET("sha,sse4.1,ssse3") void sha1_block_ni(SHA_CTX *c, unsigned long *W, unsigned char *data, int num);
+#endif
+
 
 #if defined(ENDIAN_LITTLE) && defined(SHA1_ASM)
 #  define	M_c2nl 		c2l
@@ -398,7 +403,9 @@ unsigned long len;
 	 * copies it to a local array.  I should be able to do this for
 	 * the C version as well....
 	 */
-#if defined(ENDIAN_BIG) || defined(SHA1_ASM)
+	/* (Both of these copy bytes into ULONG words, so they are only
+	 * for 32 bit longs; LP64 takes the byte at a time path.) */
+#if (defined(ENDIAN_BIG) || defined(SHA1_ASM)) && !defined(__LP64__)
 	if ((((unsigned long)data)%sizeof(ULONG)) == 0)
 		{
 		sw=len/SHA_CBLOCK;
@@ -410,13 +417,23 @@ unsigned long len;
 			len-=sw;
 			}
 		}
+#endif
+#ifdef USE_CPU_FLAGS
+	/* The SHA instructions take whole blocks straight from the data: */
+	if (len >= SHA_CBLOCK && (CPU_Flags() & CPU_SHA))
+		{
+		sw=(int)(len/SHA_CBLOCK)*SHA_CBLOCK;
+		sha1_block_ni(c,NULL,data,sw);
+		data+=sw;
+		len-=sw;
+		}
 #endif
 	/* we now can process the input data in blocks of SHA_CBLOCK
 	 * chars and save the leftovers to c->data. */
 	p=c->data;
 	while (len >= SHA_CBLOCK)
 		{
-#if defined(ENDIAN_BIG) || defined(ENDIAN_LITTLE)
+#if (defined(ENDIAN_BIG) || defined(ENDIAN_LITTLE)) && !defined(__LP64__)
 		if (p != (unsigned long *)data)
 			memcpy(p,data,SHA_CBLOCK);
 		data+=SHA_CBLOCK;
@@ -498,6 +515,89 @@ unsigned char *b;
 
 #ifndef SHA1_ASM
 
+#ifdef USE_CPU_FLAGS
+
+/* Four rounds with the x86 SHA instructions, also extending the
+ * message schedule (m0 is this group's words, m1 - m3 the next).
+ * e0 takes the message and e1 keeps A for the next group. */
+#define SHA1_ROUNDS(n, m0, m1, m2, m3, e0, e1) \
+	e0 = _mm_sha1nexte_epu32(e0, m0); \
+	e1 = abcd; \
+	if (n >= 3 && n <= 18) m1 = _mm_sha1msg2_epu32(m1, m0); \
+	abcd = _mm_sha1rnds4_epu32(abcd, e0, n / 5); \
+	if (n >= 1 && n <= 16) m3 = _mm_sha1msg1_epu32(m3, m0); \
+	if (n >= 2 && n <= 17) m2 = _mm_xor_si128(m2, m0);
+
+static TARGET("sha,sse4.1,ssse3") void sha1_block_ni(SHA_CTX *c, unsigned long *W, unsigned char *data, int num)
+	{
+	const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	__m128i abcd, abcd_save, e0, e0_save, e1;
+	__m128i m0, m1, m2, m3;
+
+	abcd = _mm_set_epi32(c->h0, c->h1, c->h2, c->h3);
+	e0 = _mm_set_epi32(c->h4, 0, 0, 0);
+
+	for (; num > 0; num -= 64)
+		{
+		abcd_save = abcd;
+		e0_save = e0;
+
+		if (data)
+			{
+			/* Big endian words, first in the top lane: */
+			m0 = _mm_shuffle_epi8(LOAD_16(data), swap);
+			m1 = _mm_shuffle_epi8(LOAD_16(data + 16), swap);
+			m2 = _mm_shuffle_epi8(LOAD_16(data + 32), swap);
+			m3 = _mm_shuffle_epi8(LOAD_16(data + 48), swap);
+			data += 64;
+			}
+		else
+			{
+			/* W already holds the block as host order words: */
+			m0 = _mm_set_epi32(W[0], W[1], W[2], W[3]);
+			m1 = _mm_set_epi32(W[4], W[5], W[6], W[7]);
+			m2 = _mm_set_epi32(W[8], W[9], W[10], W[11]);
+			m3 = _mm_set_epi32(W[12], W[13], W[14], W[15]);
+			W += 16;
+			}
+
+		e0 = _mm_add_epi32(e0, m0);
+		e1 = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+		SHA1_ROUNDS( 1, m1, m2, m3, m0, e1, e0);
+		SHA1_ROUNDS( 2, m2, m3, m0, m1, e0, e1);
+		SHA1_ROUNDS( 3, m3, m0, m1, m2, e1, e0);
+		SHA1_ROUNDS( 4, m0, m1, m2, m3, e0, e1);
+		SHA1_ROUNDS( 5, m1, m2, m3, m0, e1, e0);
+		SHA1_ROUNDS( 6, m2, m3, m0, m1, e0, e1);
+		SHA1_ROUNDS( 7, m3, m0, m1, m2, e1, e0);
+		SHA1_ROUNDS( 8, m0, m1, m2, m3, e0, e1);
+		SHA1_ROUNDS( 9, m1, m2, m3, m0, e1, e0);
+		SHA1_ROUNDS(10, m2, m3, m0, m1, e0, e1);
+		SHA1_ROUNDS(11, m3, m0, m1, m2, e1, e0);
+		SHA1_ROUNDS(12, m0, m1, m2, m3, e0, e1);
+		SHA1_ROUNDS(13, m1, m2, m3, m0, e1, e0);
+		SHA1_ROUNDS(14, m2, m3, m0, m1, e0, e1);
+		SHA1_ROUNDS(15, m3, m0, m1, m2, e1, e0);
+		SHA1_ROUNDS(16, m0, m1, m2, m3, e0, e1);
+		SHA1_ROUNDS(17, m1, m2, m3, m0, e1, e0);
+		SHA1_ROUNDS(18, m2, m3, m0, m1, e0, e1);
+		SHA1_ROUNDS(19, m3, m0, m1, m2, e1, e0);
+
+		e0 = _mm_sha1nexte_epu32(e0, e0_save);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+		}
+
+	c->h0 = (u32)_mm_extract_epi32(abcd, 3);
+	c->h1 = (u32)_mm_extract_epi32(abcd, 2);
+	c->h2 = (u32)_mm_extract_epi32(abcd, 1);
+	c->h3 = (u32)_mm_extract_epi32(abcd, 0);
+	c->h4 = (u32)_mm_extract_epi32(e0, 3);
+	}
+
+#endif
+
 static void sha1_block(c, W, num)
 SHA_CTX *c;
 register unsigned long *W;
@@ -506,6 +606,14 @@ int num;
 	register ULONG A,B,C,D,E,T;
 	ULONG X[16];
 
+#ifdef USE_CPU_FLAGS
+	if (CPU_Flags() & CPU_SHA)
+		{
+		sha1_block_ni(c, W, NULL, num);
+		return;
+		}
+#endif
+
 	A=c->h0;
 	B=c->h1;
 	C=c->h2;
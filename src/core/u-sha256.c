@@ -0,0 +1,288 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Module:  u-sha256.c
+**  Summary: SHA-256 secure hash (FIPS 180-4)
+**  Section: utility
+**  Notes:
+**    Uses the x86 SHA instructions when the CPU has them.
+**    Same calling interface as SHA1 (see sys-digest.h).
+**
+***********************************************************************/
+
+#include "sys-core.h"
+#include "sys-simd.h"
+
+#define SHA256_BLOCK 64
+#define SHA256_DIGEST_LENGTH 32
+
+typedef struct Sha256_Ctx {
+	u32 state[8];
+	REBU64 count;		// bytes hashed
+	REBYTE data[SHA256_BLOCK];
+	REBCNT num;			// bytes in data
+} SHA256_CTX;
+
+static const u32 K256[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define GET_BE32(p) (((u32)(p)[0] << 24) | ((u32)(p)[1] << 16) | ((u32)(p)[2] << 8) | (p)[3])
+
+
+/***********************************************************************
+**
+*/	static void Sha256_Blocks(u32 *state, REBYTE *data, REBCNT blocks)
+/*
+***********************************************************************/
+{
+	u32 w[64];
+	u32 a, b, c, d, e, f, g, h, t1, t2;
+	int i;
+
+	for (; blocks > 0; blocks--, data += SHA256_BLOCK) {
+		for (i = 0; i < 16; i++) w[i] = GET_BE32(data + i * 4);
+		for (; i < 64; i++) {
+			t1 = w[i-2];
+			t2 = w[i-15];
+			w[i] = (ROR(t1, 17) ^ ROR(t1, 19) ^ (t1 >> 10)) + w[i-7]
+				+ (ROR(t2, 7) ^ ROR(t2, 18) ^ (t2 >> 3)) + w[i-16];
+		}
+
+		a = state[0]; b = state[1]; c = state[2]; d = state[3];
+		e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+		for (i = 0; i < 64; i++) {
+			t1 = h + (ROR(e, 6) ^ ROR(e, 11) ^ ROR(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+			t2 = (ROR(a, 2) ^ ROR(a, 13) ^ ROR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+}
+
+
+#ifdef USE_CPU_FLAGS
+
+// Four rounds, also extending the message schedule (m0 - m3 are
+// the words of this group and the next three):
+#define SHA256_ROUNDS(n, m0, m1, m2, m3) \
+	msg = _mm_add_epi32(m0, _mm_loadu_si128((__m128i *)(K256 + n * 4))); \
+	cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg); \
+	if (n >= 3 && n <= 14) { \
+		m1 = _mm_add_epi32(m1, _mm_alignr_epi8(m0, m3, 4)); \
+		m1 = _mm_sha256msg2_epu32(m1, m0); \
+	} \
+	abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0E)); \
+	if (n >= 1 && n <= 12) m3 = _mm_sha256msg1_epu32(m3, m0);
+
+/***********************************************************************
+**
+*/	static TARGET("sha,sse4.1,ssse3") void Sha256_Blocks_NI(u32 *state, REBYTE *data, REBCNT blocks)
+/*
+**		Same as Sha256_Blocks, with the x86 SHA instructions.
+**
+***********************************************************************/
+{
+	const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	__m128i abef, cdgh, abef_save, cdgh_save;
+	__m128i msg, m0, m1, m2, m3, tmp;
+
+	// The instructions keep the state as ABEF and CDGH:
+	tmp = _mm_shuffle_epi32(LOAD_16(state), 0xB1);		// CDAB
+	cdgh = _mm_shuffle_epi32(LOAD_16(state + 4), 0x1B);	// EFGH
+	abef = _mm_alignr_epi8(tmp, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);
+
+	for (; blocks > 0; blocks--, data += SHA256_BLOCK) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+
+		m0 = _mm_shuffle_epi8(LOAD_16(data), swap);
+		m1 = _mm_shuffle_epi8(LOAD_16(data + 16), swap);
+		m2 = _mm_shuffle_epi8(LOAD_16(data + 32), swap);
+		m3 = _mm_shuffle_epi8(LOAD_16(data + 48), swap);
+
+		SHA256_ROUNDS( 0, m0, m1, m2, m3);
+		SHA256_ROUNDS( 1, m1, m2, m3, m0);
+		SHA256_ROUNDS( 2, m2, m3, m0, m1);
+		SHA256_ROUNDS( 3, m3, m0, m1, m2);
+		SHA256_ROUNDS( 4, m0, m1, m2, m3);
+		SHA256_ROUNDS( 5, m1, m2, m3, m0);
+		SHA256_ROUNDS( 6, m2, m3, m0, m1);
+		SHA256_ROUNDS( 7, m3, m0, m1, m2);
+		SHA256_ROUNDS( 8, m0, m1, m2, m3);
+		SHA256_ROUNDS( 9, m1, m2, m3, m0);
+		SHA256_ROUNDS(10, m2, m3, m0, m1);
+		SHA256_ROUNDS(11, m3, m0, m1, m2);
+		SHA256_ROUNDS(12, m0, m1, m2, m3);
+		SHA256_ROUNDS(13, m1, m2, m3, m0);
+		SHA256_ROUNDS(14, m2, m3, m0, m1);
+		SHA256_ROUNDS(15, m3, m0, m1, m2);
+
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+	}
+
+	tmp = _mm_shuffle_epi32(abef, 0x1B);				// FEBA
+	cdgh = _mm_shuffle_epi32(cdgh, 0xB1);				// DCHG
+	STORE_16(state, _mm_blend_epi16(tmp, cdgh, 0xF0));	// DCBA
+	STORE_16(state + 4, _mm_alignr_epi8(cdgh, tmp, 8));	// HGFE
+}
+
+#endif
+
+
+/***********************************************************************
+**
+*/	static void Sha256_Run(SHA256_CTX *ctx, REBYTE *data, REBCNT blocks)
+/*
+***********************************************************************/
+{
+#ifdef USE_CPU_FLAGS
+	if (CPU_Flags() & CPU_SHA) {
+		Sha256_Blocks_NI(ctx->state, data, blocks);
+		return;
+	}
+#endif
+	Sha256_Blocks(ctx->state, data, blocks);
+}
+
+
+/***********************************************************************
+**
+*/	void SHA256_Init(void *c)
+/*
+***********************************************************************/
+{
+	static const u32 init[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	SHA256_CTX *ctx = c;
+
+	memcpy(ctx->state, init, sizeof(init));
+	ctx->count = 0;
+	ctx->num = 0;
+}
+
+
+/***********************************************************************
+**
+*/	void SHA256_Update(void *c, REBYTE *data, REBCNT len)
+/*
+***********************************************************************/
+{
+	SHA256_CTX *ctx = c;
+	REBCNT n;
+
+	ctx->count += len;
+
+	if (ctx->num) {
+		n = MIN(len, SHA256_BLOCK - ctx->num);
+		memcpy(ctx->data + ctx->num, data, n);
+		ctx->num += n;
+		data += n;
+		len -= n;
+		if (ctx->num < SHA256_BLOCK) return;
+		Sha256_Run(ctx, ctx->data, 1);
+		ctx->num = 0;
+	}
+
+	// Whole blocks straight from the input:
+	if (len >= SHA256_BLOCK) {
+		n = len / SHA256_BLOCK;
+		Sha256_Run(ctx, data, n);
+		data += n * SHA256_BLOCK;
+		len -= n * SHA256_BLOCK;
+	}
+
+	memcpy(ctx->data, data, len);
+	ctx->num = len;
+}
+
+
+/***********************************************************************
+**
+*/	void SHA256_Final(REBYTE *md, void *c)
+/*
+***********************************************************************/
+{
+	SHA256_CTX *ctx = c;
+	REBU64 bits = ctx->count << 3;
+	int i;
+
+	// Pad with 0x80, zeros, then the bit count (big endian):
+	ctx->data[ctx->num++] = 0x80;
+	if (ctx->num > SHA256_BLOCK - 8) {
+		CLEAR(ctx->data + ctx->num, SHA256_BLOCK - ctx->num);
+		Sha256_Run(ctx, ctx->data, 1);
+		ctx->num = 0;
+	}
+	CLEAR(ctx->data + ctx->num, SHA256_BLOCK - 8 - ctx->num);
+	for (i = 0; i < 8; i++) ctx->data[SHA256_BLOCK - 1 - i] = (REBYTE)(bits >> (i * 8));
+	Sha256_Run(ctx, ctx->data, 1);
+
+	for (i = 0; i < 8; i++) {
+		md[i*4]   = (REBYTE)(ctx->state[i] >> 24);
+		md[i*4+1] = (REBYTE)(ctx->state[i] >> 16);
+		md[i*4+2] = (REBYTE)(ctx->state[i] >> 8);
+		md[i*4+3] = (REBYTE)ctx->state[i];
+	}
+	ctx->num = 0;
+}
+
+
+/***********************************************************************
+**
+*/	int SHA256_CtxSize(void)
+/*
+***********************************************************************/
+{
+	return sizeof(SHA256_CTX);
+}
+
+
+/***********************************************************************
+**
+*/	REBYTE *SHA256(REBYTE *d, REBCNT n, REBYTE *md)
+/*
+***********************************************************************/
+{
+	SHA256_CTX ctx;
+
+	SHA256_Init(&ctx);
+	SHA256_Update(&ctx, d, n);
+	SHA256_Final(md, &ctx);
+	CLEAR(&ctx, sizeof(ctx));
+	return md;
+}
@@ -45,6 +45,16 @@
 // the REBNATIVE(do_codec) in n-system.c
 // so the deallocation is left to GC
 //
+// If your codec routine returns CODI_BLOCK, the ->other field is
+// the block series (GC protected by the codec until it returns).
+// On decode it may lower ->len to the part of the data it used;
+// do_codec then removes that part from the input binary!, so the
+// caller can append more data and decode again (streaming). With
+// the more option the used part is removed even if it is all.
+//
+// For encode of other than an image!, ->block is the value (REBVAL *).
+// The ->opts field is the /options block value (REBVAL *), or 0.
+//
 typedef struct reb_codec_image {
 	int action;
 	int w;
@@ -57,6 +67,8 @@ typedef struct reb_codec_image {
 		void *other;
 	};
 	int error;
+	void *opts;
+	void *block;
 } REBCDI;
 
 typedef REBINT (*codo)(REBCDI *cdi);
@@ -91,6 +91,7 @@ These are now obsolete (as of A107) and should be removed:
 #define OS_CRLF TRUE			// uses CRLF as line terminator
 #define OS_DIR_SEP '\\'			// file path separator (Thanks Bill.)
 #define HAS_ASYNC_DNS			// supports it
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #define ATOI					// supports it
 #define ATOI64					// supports it
 #define ITOA64					// supports it
@@ -148,21 +149,29 @@ These are now obsolete (as of A107) and should be removed:
 #ifdef TO_LINUX					// Linux/Intel
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_LINUX_PPC				// Linux/PPC
 #define ENDIAN_BIG
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_LINUX_ARM				// Linux/ARM
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_LINUX_MIPS
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_HAIKU					// same as Linux/Intel seems to work
@@ -173,6 +182,8 @@ These are now obsolete (as of A107) and should be removed:
 #ifdef TO_OSXI					// OSX/Intel
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_OSX					// OSX/PPC
@@ -184,11 +195,15 @@ These are now obsolete (as of A107) and should be removed:
 #ifdef TO_FREEBSD
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_OPENBSD
 #define ENDIAN_LITTLE
 #define HAS_LL_CONSTS
+#define HAS_ASYNC_FILE			// worker threads for file IO
+#define HAS_THREADS				// host can run worker jobs (OS_Run_Jobs)
 #endif
 
 #ifdef TO_OBSD					// OpenBSD
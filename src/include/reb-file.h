@@ -37,6 +37,8 @@ enum {
 	RFM_TRUNCATE,
 	RFM_RESEEK,			// file index has moved, reseek
 	RFM_NAME_MEM,		// converted name allocated in mem
+	RFM_MAP,			// map file into memory rather than read it
+	RFM_ASYNC,			// read and write on a worker thread
 	RFM_DIR = 16,
 };
 
@@ -31,6 +31,7 @@ enum socket_types {
 	RST_UDP,					// TCP or UDP
 	RST_LISTEN = 8,				// LISTEN
 	RST_REVERSE,				// DNS reverse
+	RST_BATCH,					// UDP batch of datagrams (see REBDGM)
 };
 
 // REBOL Socket Modes (state flags)
@@ -45,4 +46,21 @@ enum {
 	RSM_ACCEPT,					// an inbound connection
 };
 
+// UDP batch transfers use a flat buffer of fixed size slots, each
+// a REBDGM header followed by the datagram payload. For READ the
+// device fills up to length/DGRAM_STRIDE slots and sets actual to
+// the number of datagrams. For WRITE the slots are packed (stride is
+// the header plus the aligned payload) and actual counts bytes sent.
+typedef struct rebol_dgram {
+	u32 length;					// payload length in bytes
+	u32 ip;						// remote address (network byte order)
+	u32 port;					// remote port
+} REBDGM;
+
+#define DGRAM_SLOT		2048	// max batch payload (larger is truncated)
+#define DGRAM_STRIDE	(sizeof(REBDGM) + DGRAM_SLOT)
+#define DGRAM_ALIGN(n)	(((n) + 3) & ~3)
+#define DGRAM_MAX		65507	// max UDP payload for IPv4
+#define UDP_BATCH_MAX	64		// max datagrams per batch
+
 #define IPA(a,b,c,d) (a<<24 | b<<16 | c<<8 | d)
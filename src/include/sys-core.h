@@ -402,6 +402,8 @@ typedef struct rebol_stats {
 	REBCNT	Free_List_Checked;
 	REBCNT	Blocks;
 	REBCNT	Objects;
+	REBCNT	Parse_Memo_Hits;
+	REBCNT	Parse_Memo_Misses;
 } REB_STATS;
 
 //-- Options of various kinds:
@@ -0,0 +1,76 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Summary: Hash Function Table
+**  Module:  sys-digest.h
+**  Notes:
+**    Shared by the CHECKSUM native and the checksum port.
+**    The table (in n-strings.c) ends with a zero entry.
+**
+***********************************************************************/
+
+#ifndef SHA_DEFINED
+#ifdef HAS_SHA1
+REBYTE *SHA1(REBYTE *, REBCNT, REBYTE *);
+void SHA1_Init(void *c);
+void SHA1_Update(void *c, REBYTE *data, REBCNT len);
+void SHA1_Final(REBYTE *md, void *c);
+int  SHA1_CtxSize(void);
+#endif
+#endif
+
+#ifndef MD5_DEFINED
+#ifdef HAS_MD5
+REBYTE *MD5(REBYTE *, REBCNT, REBYTE *);
+void MD5_Init(void *c);
+void MD5_Update(void *c, REBYTE *data, REBCNT len);
+void MD5_Final(REBYTE *md, void *c);
+int  MD5_CtxSize(void);
+#endif
+#endif
+
+#ifdef HAS_MD4
+REBYTE *MD4(REBYTE *, REBCNT, REBYTE *);
+void MD4_Init(void *c);
+void MD4_Update(void *c, REBYTE *data, REBCNT len);
+void MD4_Final(REBYTE *md, void *c);
+int  MD4_CtxSize(void);
+#endif
+
+REBCNT Update_CRC32(u32 crc, REBYTE *buf, int len); // s-crc.c
+REBCNT Update_CRC32C(u32 crc, REBYTE *buf, int len);
+
+#define MAX_DIGEST_LEN 32	// largest len below
+#define MAX_DIGEST_BLOCK 64	// largest hmacblock below
+
+// Table of hash functions and parameters:
+typedef struct rebol_digest {
+	REBYTE *(*digest)(REBYTE *, REBCNT, REBYTE *);
+	void (*init)(void *);
+	void (*update)(void *, REBYTE *, REBCNT);
+	void (*final)(REBYTE *, void *);
+	int (*ctxsize)(void);
+	REBINT index;
+	REBINT len;
+	REBINT hmacblock;
+} REBDIG;
+
+extern REBDIG Digests[];
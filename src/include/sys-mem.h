@@ -82,6 +82,38 @@ typedef void *REBNOD;			// Just used for linking free nodes
 } REBPOL;
 
 
+/***********************************************************************
+**
+*/	typedef struct rebol_mapped_file
+/*
+**		A file mapped into memory (see GC_Mapped). It is shared by
+**		all series with data inside it, and is unmapped when the
+**		last of them is freed.
+**
+***********************************************************************/
+{
+	REBYTE	*data;				// start of the mapping
+	REBCNT	size;				// length of the mapping (with terminator)
+	REBCNT	refs;				// number of series using it
+} MAPPED_FILE;
+
+
+/***********************************************************************
+**
+*/	typedef struct rebol_final_mem
+/*
+**		Memory outside of series (see GC_Finals), such as a C
+**		library's state for a port. It is freed by its function
+**		when the owner series is collected.
+**
+***********************************************************************/
+{
+	REBSER	*owner;				// series that uses the memory
+	void	*data;				// start of the memory
+	void	(*free_func)(void *);	// frees the memory
+} FINAL_MEM;
+
+
 /***********************************************************************
 **
 */	enum Mem_Pool_Specs
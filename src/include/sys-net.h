@@ -86,6 +86,11 @@ typedef struct hostent HOSTENT;
 #define MAXGETHOSTSTRUCT ((sizeof(struct hostent)+15) & ~15)
 #endif
 
+// Linux can move a batch of datagrams per system call (glibc 2.14):
+#if defined(TO_LINUX) && defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 14)
+#define HAS_MMSG
+#endif
+
 #endif // BSD
 
 typedef struct sockaddr_in SOCKAI; // Internet extensions
@@ -197,6 +197,8 @@ typedef struct rebol_scan_state {
 	REBYTE *head_line;		// head of current line (used for errors)
 	REBCNT opts;
 	REBCNT errors;
+	struct rebol_scan_ahead *ahead;	// tokens found by workers (load/parallel)
+	struct rebol_scan_token *token;	// the one last returned (or zero)
 } SCAN_STATE;
 
 #define ACCEPT_TOKEN(s) ((s)->begin = (s)->end)
@@ -207,6 +209,7 @@ enum {
 	SCAN_NEXT,	// load/next feature
 	SCAN_ONLY,  // only single value (no blocks)
 	SCAN_RELAX,	// no error throw
+	SCAN_LEX,	// find tokens only (no BUF_MOLD output, worker threads)
 };
 
 /*
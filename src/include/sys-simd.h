@@ -0,0 +1,79 @@
+/***********************************************************************
+**
+**  REBOL [R3] Language Interpreter and Run-time Environment
+**
+**  Copyright 2012 REBOL Technologies
+**  REBOL is a trademark of REBOL Technologies
+**
+**  Licensed under the Apache License, Version 2.0 (the "License");
+**  you may not use this file except in compliance with the License.
+**  You may obtain a copy of the License at
+**
+**  http://www.apache.org/licenses/LICENSE-2.0
+**
+**  Unless required by applicable law or agreed to in writing, software
+**  distributed under the License is distributed on an "AS IS" BASIS,
+**  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+**  See the License for the specific language governing permissions and
+**  limitations under the License.
+**
+************************************************************************
+**
+**  Summary: Vector Instruction Definitions
+**  Module:  sys-simd.h
+**  Notes:
+**    Code that works on 16 bytes at a time uses SSE2 where the
+**    compiler provides it (all x86-64, and x86 built with -msse2).
+**    USE_SSE2 is defined then; each use must also keep its plain C
+**    loop, which is what all other CPUs run.
+**
+**    Later instructions (PSHUFB, CRC32, PCLMULQDQ, SHA) cannot be
+**    assumed even there, so they go only in functions marked TARGET,
+**    called only when CPU_Flags() says the CPU has them.
+**
+***********************************************************************/
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+static INLINE int Lowest_Bit(unsigned int mask) {unsigned long n; _BitScanForward(&n, mask); return n;}
+static INLINE int Count_Bits(unsigned int n) {
+	n -= (n >> 1) & 0x55555555;
+	n = (n & 0x33333333) + ((n >> 2) & 0x33333333);
+	return (((n + (n >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+#else
+#define Lowest_Bit(mask) __builtin_ctz(mask)
+#define Count_Bits(mask) __builtin_popcount(mask)
+#endif
+
+#define SPLAT(c) _mm_set1_epi8((char)(c))
+#define IS_CHR(v, c) _mm_cmpeq_epi8(v, SPLAT(c))
+#define LOAD_16(p) _mm_loadu_si128((__m128i *)(p))
+#define STORE_16(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define HIGH_BITS(v) ((unsigned int)_mm_movemask_epi8(v))	// one bit per byte
+
+#endif
+
+#if defined(USE_SSE2) && (defined(_MSC_VER) || defined(__clang__) || __GNUC__ >= 5)
+#define USE_CPU_FLAGS
+#include <immintrin.h>
+
+#define CPU_SSE42	1	// CRC32 instruction (CRC-32C)
+#define CPU_PCLMUL	2	// carry-less multiply, with SSE4.1
+#define CPU_SHA		4	// SHA-1 and SHA-256, with SSE4.1
+#define CPU_SSSE3	8	// byte shuffle (PSHUFB)
+
+#ifdef _MSC_VER
+#define TARGET(x)
+#define CPUID(leaf, r) __cpuidex(r, leaf, 0)
+#else
+#include <cpuid.h>
+#define TARGET(x) __attribute__((target(x)))
+#define CPUID(leaf, r) __cpuid_count(leaf, 0, r[0], r[1], r[2], r[3])
+#endif
+
+#endif
@@ -61,6 +61,8 @@ foreach [codec handler] system/codecs [
 				gif  [%.gif]
 				jpeg [%.jpg %.jpeg]
 				png  [%.png]
+				csv  [%.csv]
+				json [%.json]
 			] codec
 		]
 		; Media-types block format: [.abc .def type ...]
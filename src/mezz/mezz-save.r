@@ -36,7 +36,18 @@ save: function [
 	/length {Save the length of the script content in the header}
 	/compress {Save in a compressed format or not}
 	method [logic! word!] "true = compressed, false = not, 'script = encoded string"
+	/binary {Save in binary encoded format (loads without scanning)}
 ][
+	;-- Binary encoded values (LOAD detects them):
+	if binary [
+		data: serialize :value
+		return case [
+			any [file? where url? where] [write where data]
+			none? where [data]
+			'else [insert tail where data]
+		]
+	]
+
 	;-- Special datatypes use codecs directly (e.g. PNG image file):
 	if lib/all [
 		not header ; User wants to save value as script, not data file
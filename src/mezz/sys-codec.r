@@ -20,26 +20,59 @@ REBOL [
 decode: function [
  	{Decodes a series of bytes into the related datatype (e.g. image!).}
 	type [word!] {Media type (jpeg, png, etc.)}
-	data [binary!] {The data to decode}
+	data [binary! port!] {The data to decode (or an open file port)}
+	/options opts [block!] {Special decoding options}
 ][
-	unless all [
-		cod: select system/codecs type
-		data: do-codec cod/entry 'decode data
-	][
+	unless cod: select system/codecs type [
+		cause-error 'access 'no-codec type
+	]
+	opts: any [opts []]
+	if port? data [
+		port: data
+		data: read/part port 65536
+		; Can it be decoded a piece at a time?
+		more: case [
+			type = 'csv [not find opts 'columns]
+			type <> 'json [false]
+			find opts 'lines [true]
+			; A top level array, an item at a time:
+			parse data [any [#" " | #"^-" | #"^/" | #"^M"] #"[" mark: to end] [
+				remove/part data mark
+				opts: append copy opts 'items
+			]
+		]
+		either more [
+			; Decode the whole rows (or values) of each chunk as it is read:
+			more: append copy opts 'more
+			out: make block! 1000
+			forever [
+				append out do-codec/options cod/entry 'decode data more
+				if empty? chunk: read/part port 65536 [break]
+				append data chunk
+			]
+			append out do-codec/options cod/entry 'decode data opts
+			return out
+		][
+			append data read port
+		]
+	]
+	unless data: do-codec/options cod/entry 'decode data opts [
 		cause-error 'access 'no-codec type
 	]
+	; JSON decodes to one value (or a block of JSON lines):
+	if all [type = 'json  not find opts 'lines  not find opts 'items] [data: first data]
 	data
 ]
 
 encode: function [
 	{Encodes a datatype (e.g. image!) into a series of bytes.}
 	type [word!] {Media type (jpeg, png, etc.)}
-	data [image! binary! string!] {The data to encode}
+	data [image! binary! string! block! map! object!] {The data to encode}
 	/options opts [block!] {Special encoding options}
 ][
 	unless all [
 		cod: select system/codecs type
-		data: do-codec cod/entry 'encode data
+		data: do-codec/options cod/entry 'encode data any [opts []]
 	][
 		cause-error 'access 'no-codec type
 	]
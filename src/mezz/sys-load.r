@@ -268,6 +268,7 @@ load: function [
 	/all     {Load all values (does not evaluate REBOL header)}
 	/type    {Override default file-type; use NONE to always load as code}
 		ftype [word! none!] "E.g. text, markup, jpeg, unbound, etc."
+	/parallel {Scan large sources using worker threads}
 ] [
 	; WATCH OUT: for ALL and NEXT words! They are local.
 
@@ -290,7 +291,7 @@ load: function [
 
 		;-- Load multiple sources?
 		block? source [
-			return map-each item source [apply :load [:item header all type ftype]]
+			return map-each item source [apply :load [:item header all type ftype parallel]]
 		]
 
 		;-- What type of file? Decode it too:
@@ -305,6 +306,12 @@ load: function [
 		]
 		none? data [data: source]
 
+		;-- Binary encoded values (from SAVE/binary)?
+		lib/all [binary? data find/match data #{00524542534552}] [
+			; Data read from a large file is used in place:
+			return either binary? source [deserialize data] [deserialize/mapped data]
+		]
+
 		;-- Is it not source code? Then return it now:
 		any [block? data not find [0 extension unbound] any [ftype 0]][ ; due to make-boot issue with #[none]
 			return data ; directory, image, txt, markup, etc.
@@ -318,7 +325,9 @@ load: function [
 		; data is binary or block now, hdr is object or none
 
 		;-- Convert code to block, insert header if requested:
-		not block? data [data: to block! data]
+		not block? data [
+			data: either parallel [head remove back tail transcode/parallel data] [to block! data]
+		]
 		header [insert data hdr]
 
 		;-- Bind code to user context:
@@ -128,6 +128,34 @@ make-port*: func [
 
 decode-url: none ; used by sys funcs, defined above, set below
 
+read-parse-chunk: func [
+	"SYS: Called by PARSE of a port for its next input (none at the end)."
+	port [port!]
+	size [integer!] "Bytes to read, when the port allows it"
+	/local data awake type result
+][
+	either any-function? get in port 'awake [
+		; The data arrives in the background (TCP, async files):
+		awake: :port/awake
+		port/awake: func [event] [type: event/type  find [read close error] type]
+		port/data: none
+		type: none
+		result: try [
+			either port/scheme/name = 'tcp [read port] [read/part port size]
+			wait [port 30] ; seconds
+		]
+		data: port/data
+		port/data: none
+		port/awake: :awake
+		if error? result [do result]
+		unless result [cause-error 'access 'timeout port/spec/ref]
+		if type = 'error [cause-error 'access 'read-error reduce [port/spec/ref type]]
+	][
+		data: read/part port size
+	]
+	all [binary? data  not empty? data  data]
+]
+
 ;-- Native Schemes -----------------------------------------------------------
 
 make-scheme: func [
@@ -259,11 +287,44 @@ init-schemes: func [
 		awake: func [event] [print ['TCP-event event/type] true]
 	]
 
+	make-scheme [
+		title: "UDP Networking"
+		name: 'udp
+		spec: system/standard/port-spec-net
+		info: system/standard/net-info ; for C enums
+		awake: func [event] [print ['UDP-event event/type] true]
+	]
+
 	make-scheme [
 		title: "Clipboard"
 		name: 'clipboard
 	]
 
+	make-scheme [
+		title: "Streaming Compression"
+		name: 'compress
+		spec: system/standard/port-spec-zip
+	]
+
+	make-scheme [
+		title: "Streaming Decompression"
+		name: 'decompress
+		spec: system/standard/port-spec-zip
+	]
+
+	make-scheme [
+		title: "Incremental Checksum"
+		name: 'checksum
+		spec: system/standard/port-spec-checksum
+		init: func [port /local method] [
+			; checksum://md5 gives the method:
+			if url? port/spec/ref [
+				parse port/spec/ref [thru #":" 0 2 slash method:]
+				unless empty? method [port/spec/method: to word! to string! method]
+			]
+		]
+	]
+
 	system/ports/system:   open [scheme: 'system]
 	system/ports/input:    open [scheme: 'console]
 	system/ports/callback: open [scheme: 'callback]
@@ -35,6 +35,10 @@
 **
 ***********************************************************************/
 
+#ifdef TO_LINUX
+#define _GNU_SOURCE				// for recvmmsg() and sendmmsg()
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -356,6 +360,14 @@ static REBOOL Nonblocking_Mode(SOCKET sock)
 
 	if (GET_FLAG(sock->state, RSM_CONNECT)) return DR_DONE; // already connected
 
+	// UDP is connectionless. Datagrams are sent with sendto() to the
+	// remote address, so the socket is ready for transfer right away:
+	if (GET_FLAG(sock->modes, RST_UDP)) {
+		SET_FLAG(sock->state, RSM_CONNECT);
+		Signal_Device(sock, EVT_CONNECT);
+		return DR_DONE;
+	}
+
 	Set_Addr(&sa, sock->net.remote_ip, sock->net.remote_port);
 	result = connect(sock->socket, (struct sockaddr *)&sa, sizeof(sa));
 
@@ -394,11 +406,194 @@ static REBOOL Nonblocking_Mode(SOCKET sock)
 }
 
 
+/***********************************************************************
+**
+*/	static DEVICE_CMD Transfer_Datagram(REBREQ *sock, int mode)
+/*
+**		Send or receive a single UDP datagram.
+**
+**		A send goes to the remote address and port of the request
+**		and is never split: the whole datagram is sent or none of
+**		it is. A receive stores the sender's address and port into
+**		the remote fields, so a following send replies to it.
+**
+***********************************************************************/
+{
+	SOCKAI sa;
+	int len = sizeof(sa);
+	int result;
+
+	if (mode == RSM_SEND) {
+		Set_Addr(&sa, sock->net.remote_ip, sock->net.remote_port);
+		result = sendto(sock->socket, sock->data, sock->length, 0, (struct sockaddr *)&sa, sizeof(sa));
+		WATCH2("sendto() len: %d actual: %d\n", sock->length, result);
+
+		if (result >= 0) {
+			sock->actual = result;
+			Signal_Device(sock, EVT_WROTE);
+			return DR_DONE;
+		}
+	}
+	else {
+		result = recvfrom(sock->socket, sock->data, sock->length, 0, (struct sockaddr *)&sa, &len);
+		WATCH2("recvfrom() len: %d result: %d\n", sock->length, result);
+
+		if (result >= 0) {
+			sock->actual = result;
+			sock->net.remote_ip = sa.sin_addr.s_addr;
+			sock->net.remote_port = ntohs(sa.sin_port);
+			Signal_Device(sock, EVT_READ);
+			return DR_DONE;
+		}
+	}
+
+	result = GET_ERROR;
+	if (result == NE_WOULDBLOCK) return DR_PEND; // still waiting
+
+	sock->error = result;
+	return DR_ERROR;
+}
+
+
+/***********************************************************************
+**
+*/	static DEVICE_CMD Transfer_Batch(REBREQ *sock, int mode)
+/*
+**		Send or receive a batch of UDP datagrams (see REBDGM).
+**
+**		Where recvmmsg() and sendmmsg() are available, the whole
+**		batch is moved with a single system call. Otherwise the
+**		datagrams are moved one at a time until the socket would
+**		block, which gives the same results.
+**
+**		A receive completes as soon as at least one datagram has
+**		arrived; actual is set to the number of datagrams stored.
+**		A send stays pending until every datagram has been sent;
+**		data and actual advance past the datagrams already sent.
+**
+***********************************************************************/
+{
+	REBDGM *dg;
+	int len;
+	int result;
+	int n;
+	int count;
+#ifndef HAS_MMSG
+	SOCKAI sa;
+#else
+	struct mmsghdr msgs[UDP_BATCH_MAX];
+	struct iovec iovs[UDP_BATCH_MAX];
+	SOCKAI addrs[UDP_BATCH_MAX];
+	REBYTE *bp;
+#endif
+
+	if (mode == RSM_SEND) {
+#ifdef HAS_MMSG
+		// Gather the packed records that remain:
+		bp = sock->data;
+		for (count = 0; count < UDP_BATCH_MAX && sock->actual + (bp - sock->data) < sock->length; count++) {
+			dg = (REBDGM*)bp;
+			Set_Addr(&addrs[count], dg->ip, dg->port);
+			iovs[count].iov_base = bp + sizeof(REBDGM);
+			iovs[count].iov_len = dg->length;
+			CLEARS(&msgs[count]);
+			msgs[count].msg_hdr.msg_name = &addrs[count];
+			msgs[count].msg_hdr.msg_namelen = sizeof(SOCKAI);
+			msgs[count].msg_hdr.msg_iov = &iovs[count];
+			msgs[count].msg_hdr.msg_iovlen = 1;
+			bp += sizeof(REBDGM) + DGRAM_ALIGN(dg->length);
+		}
+
+		result = sendmmsg(sock->socket, msgs, count, 0);
+		WATCH2("sendmmsg() count: %d result: %d\n", count, result);
+
+		if (result >= 0) {
+			for (n = 0; n < result; n++) {
+				len = sizeof(REBDGM) + DGRAM_ALIGN(((REBDGM*)sock->data)->length);
+				sock->data += len;
+				sock->actual += len;
+			}
+		}
+#else
+		result = 0;
+		while (sock->actual < sock->length) {
+			dg = (REBDGM*)sock->data;
+			Set_Addr(&sa, dg->ip, dg->port);
+			result = sendto(sock->socket, sock->data + sizeof(REBDGM), dg->length, 0, (struct sockaddr *)&sa, sizeof(sa));
+			if (result < 0) break;
+			len = sizeof(REBDGM) + DGRAM_ALIGN(dg->length);
+			sock->data += len;
+			sock->actual += len;
+		}
+#endif
+		if (result >= 0 || GET_ERROR == NE_WOULDBLOCK) {
+			if (sock->actual >= sock->length) {
+				Signal_Device(sock, EVT_WROTE);
+				return DR_DONE;
+			}
+			return DR_PEND;
+		}
+	}
+	else {
+		n = sock->length / DGRAM_STRIDE;
+#ifdef HAS_MMSG
+		if (n > UDP_BATCH_MAX) n = UDP_BATCH_MAX;
+		for (count = 0; count < n; count++) {
+			iovs[count].iov_base = sock->data + count * DGRAM_STRIDE + sizeof(REBDGM);
+			iovs[count].iov_len = DGRAM_SLOT;
+			CLEARS(&msgs[count]);
+			msgs[count].msg_hdr.msg_name = &addrs[count];
+			msgs[count].msg_hdr.msg_namelen = sizeof(SOCKAI);
+			msgs[count].msg_hdr.msg_iov = &iovs[count];
+			msgs[count].msg_hdr.msg_iovlen = 1;
+		}
+
+		result = recvmmsg(sock->socket, msgs, n, 0, 0);
+		WATCH2("recvmmsg() count: %d result: %d\n", n, result);
+
+		for (count = 0; count < result; count++) {
+			dg = (REBDGM*)(sock->data + count * DGRAM_STRIDE);
+			dg->length = msgs[count].msg_len;
+			dg->ip = addrs[count].sin_addr.s_addr;
+			dg->port = ntohs(addrs[count].sin_port);
+		}
+#else
+		for (result = 0; result < n; result++) {
+			dg = (REBDGM*)(sock->data + result * DGRAM_STRIDE);
+			len = sizeof(sa);
+			count = recvfrom(sock->socket, (REBYTE*)(dg + 1), DGRAM_SLOT, 0, (struct sockaddr *)&sa, &len);
+			if (count < 0) break;
+			dg->length = count;
+			dg->ip = sa.sin_addr.s_addr;
+			dg->port = ntohs(sa.sin_port);
+		}
+		if (result == 0) result = -1; // nothing arrived, check error below
+#endif
+		if (result > 0) {
+			// The last sender becomes the remote (for replies and QUERY):
+			dg = (REBDGM*)(sock->data + (result - 1) * DGRAM_STRIDE);
+			sock->actual = result;
+			sock->net.remote_ip = dg->ip;
+			sock->net.remote_port = dg->port;
+			Signal_Device(sock, EVT_READ);
+			return DR_DONE;
+		}
+	}
+
+	result = GET_ERROR;
+	if (result == NE_WOULDBLOCK) return DR_PEND; // still waiting
+
+	sock->error = result;
+	return DR_ERROR;
+}
+
+
 /***********************************************************************
 **
 */	DEVICE_CMD Transfer_Socket(REBREQ *sock)
 /*
-**		Write or read a socket (for connection-based protocols).
+**		Write or read a socket. UDP sockets are handed off to
+**		Transfer_Datagram or Transfer_Batch.
 **
 **		This function is asynchronous. It will return immediately.
 **		You can call this function again to check the pending connection.
@@ -431,6 +626,11 @@ static REBOOL Nonblocking_Mode(SOCKET sock)
 
 	SET_FLAG(sock->state, mode);
 
+	if (GET_FLAG(sock->modes, RST_UDP)) {
+		if (GET_FLAG(sock->modes, RST_BATCH)) return Transfer_Batch(sock, mode);
+		return Transfer_Datagram(sock, mode);
+	}
+
 	// Limit size of transfer:
 	len = MIN(sock->length, MAX_TRANSFER);
 
@@ -516,13 +716,19 @@ lserr:
 
 	SET_FLAG(sock->state, RSM_BIND);
 
-	// For TCP connections, setup listen queue:
-	if (!GET_FLAG(sock->modes, RST_UDP)) {
-		result = listen(sock->socket, SOMAXCONN);
-		if (result) goto lserr;
-		SET_FLAG(sock->state, RSM_LISTEN);
+	// For UDP, a bound socket is ready to receive datagrams:
+	if (GET_FLAG(sock->modes, RST_UDP)) {
+		Get_Local_IP(sock);
+		SET_FLAG(sock->state, RSM_CONNECT);
+		Signal_Device(sock, EVT_CONNECT);
+		return DR_DONE;
 	}
 
+	// For TCP connections, setup listen queue:
+	result = listen(sock->socket, SOMAXCONN);
+	if (result) goto lserr;
+	SET_FLAG(sock->state, RSM_LISTEN);
+
 	Get_Local_IP(sock);
 	sock->command = RDC_CREATE;	// the command done on wakeup
 
@@ -45,10 +45,20 @@
 #include <fcntl.h>
 #include <dirent.h>
 #include <errno.h>
+#include <sys/mman.h>
 
 #include "reb-host.h"
 #include "host-lib.h"
 
+#ifdef HAS_ASYNC_FILE
+#include <pthread.h>
+static void Wait_File_Job(REBREQ *file);
+#endif
+
+extern REBDEV Dev_File;
+void Signal_Device(REBREQ *req, REBINT type);
+void Detach_Request(REBREQ **node, REBREQ *req);
+
 #ifndef O_BINARY
 #define O_BINARY 0
 #endif
@@ -61,6 +71,10 @@
 #define S_IWRITE S_IWUSR
 #endif
 
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
 // NOTE: the code below assumes a file id will never by zero. This should
 // be safe. In posix, zero is stdin, which is handled by dev-stdio.c.
 
@@ -338,6 +352,13 @@ fail:
 **
 ***********************************************************************/
 {
+#ifdef HAS_ASYNC_FILE
+	if (GET_FLAG(file->flags, RRF_PENDING)) {
+		Wait_File_Job(file);
+		Detach_Request(&Dev_File.pending, file);
+	}
+#endif
+
 	if (file->id) {
 		close(file->id);
 		file->id = 0;
@@ -346,29 +367,56 @@ fail:
 }
 
 
-/***********************************************************************
-**
-*/	DEVICE_CMD Read_File(REBREQ *file)
-/*
-***********************************************************************/
+static int Map_File(REBREQ *file)
 {
-	if (GET_FLAG(file->modes, RFM_DIR)) {
-		return Read_Directory(file, (REBREQ*)file->data);
-	}
+	// Map a regular file into memory rather than reading it.
+	// An extra zero page is reserved first so that the data can
+	// always be terminated. Pages are private (copy on write).
+	// Returns FALSE if the file cannot be mapped.
+	struct stat info;
+	size_t size;
+	void *mem;
 
-	if (!file->id) {
-		file->error = -RFE_NO_HANDLE;
-		return DR_ERROR;
+	if (file->file.index != 0) return FALSE;
+	if (fstat(file->id, &info) || !S_ISREG(info.st_mode)) return FALSE;
+	if (info.st_size < file->length) return FALSE;
+
+	size = file->length + 1; // terminator
+	mem = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mem == MAP_FAILED) return FALSE;
+
+	if (mmap(mem, file->length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file->id, 0) == MAP_FAILED) {
+		munmap(mem, size);
+		return FALSE;
 	}
 
+	file->data = mem;
+	file->actual = file->length;
+	file->file.index += file->actual;
+	return TRUE;
+}
+
+
+static int Read_File_Now(REBREQ *file)
+{
+	// Perform the read (in the caller's or a worker's thread).
 	if (file->modes & ((1 << RFM_SEEK) | (1 << RFM_RESEEK))) {
 		CLR_FLAG(file->modes, RFM_RESEEK);
 		if (!Seek_File_64(file)) return DR_ERROR;
 	}
 
+	// Map the file, or let the caller do a normal read:
+	if (GET_FLAG(file->modes, RFM_MAP)) {
+		if (!Map_File(file)) {
+			CLR_FLAG(file->modes, RFM_MAP);
+			file->actual = 0;
+		}
+		return DR_DONE;
+	}
+
 	// printf("read %d len %d\n", file->id, file->length);
 	file->actual = read(file->id, file->data, file->length);
-	if (file->actual < 0) {
+	if ((i32)file->actual < 0) {
 		file->error = -RFE_BAD_READ;
 		return DR_ERROR;
 	} else {
@@ -379,19 +427,9 @@ fail:
 }
 
 
-/***********************************************************************
-**
-*/	DEVICE_CMD Write_File(REBREQ *file)
-/*
-**	Bug?: update file->size value after write !?
-**
-***********************************************************************/
+static int Write_File_Now(REBREQ *file)
 {
-	if (!file->id) {
-		file->error = -RFE_NO_HANDLE;
-		return DR_ERROR;
-	}
-
+	// Perform the write (in the caller's or a worker's thread).
 	if (GET_FLAG(file->modes, RFM_APPEND)) {
 		CLR_FLAG(file->modes, RFM_APPEND);
 		lseek(file->id, 0, SEEK_END);
@@ -400,23 +438,173 @@ fail:
 	if (file->modes & ((1 << RFM_SEEK) | (1 << RFM_RESEEK) | (1 << RFM_TRUNCATE))) {
 		CLR_FLAG(file->modes, RFM_RESEEK);
 		if (!Seek_File_64(file)) return DR_ERROR;
-		if (GET_FLAG(file->modes, RFM_TRUNCATE))
-			if (ftruncate(file->id, file->file.index)) return DR_ERROR;
+		if (GET_FLAG(file->modes, RFM_TRUNCATE)) {
+			if (ftruncate(file->id, file->file.index)) {
+				file->error = -RFE_BAD_WRITE;
+				return DR_ERROR;
+			}
+		}
 	}
 
 	if (file->length == 0) return DR_DONE;
 
 	file->actual = write(file->id, file->data, file->length);
-	if (file->actual < 0) {
+	if ((i32)file->actual < 0) {
 		if (errno == ENOSPC) file->error = -RFE_DISK_FULL;
 		else file->error = -RFE_BAD_WRITE;
 		return DR_ERROR;
+	} else {
+		file->file.index += file->actual;
 	}
 
 	return DR_DONE;
 }
 
 
+#ifdef HAS_ASYNC_FILE
+
+/***********************************************************************
+**
+**	Async File Workers
+**
+**	Requests for files opened with RFM_ASYNC are queued to a small
+**	pool of threads. The device returns DR_PEND, so the request is
+**	attached to the pending list, and Poll_File signals its READ,
+**	WROTE or ERROR event once a worker has finished it. Only this
+**	file holds the locks; the rest of REBOL stays single threaded.
+**
+***********************************************************************/
+
+#define FILE_WORKERS 4		// threads in the pool
+#define FILE_JOBS 64		// max async requests in progress
+
+static pthread_mutex_t Job_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t Job_Ready = PTHREAD_COND_INITIALIZER;	// job queued
+static pthread_cond_t Job_Done = PTHREAD_COND_INITIALIZER;	// job finished
+static REBREQ *Jobs[FILE_JOBS];		// queued requests (ring)
+static REBREQ *Done[FILE_JOBS];		// finished requests
+static int Job_Head;
+static int Job_Count;
+static int Done_Count;
+static int In_Flight;		// queued + running + done
+static int Workers;			// threads started
+
+static void *File_Worker(void *arg)
+{
+	REBREQ *file;
+
+	pthread_mutex_lock(&Job_Lock);
+	while (TRUE) {
+		while (Job_Count == 0) pthread_cond_wait(&Job_Ready, &Job_Lock);
+		file = Jobs[Job_Head];
+		Job_Head = (Job_Head + 1) % FILE_JOBS;
+		Job_Count--;
+		pthread_mutex_unlock(&Job_Lock);
+
+		if (file->command == RDC_WRITE) Write_File_Now(file);
+		else Read_File_Now(file);
+
+		pthread_mutex_lock(&Job_Lock);
+		Done[Done_Count++] = file;
+		pthread_cond_broadcast(&Job_Done);
+	}
+	return 0;
+}
+
+static int Queue_File_Job(REBREQ *file)
+{
+	// Give the request to a worker. Returns FALSE if it cannot be
+	// queued, and the caller then performs it synchronously.
+	pthread_t thread;
+	int ok = FALSE;
+
+	pthread_mutex_lock(&Job_Lock);
+	for (; Workers < FILE_WORKERS; Workers++) { // first use
+		if (pthread_create(&thread, 0, File_Worker, 0)) break;
+		pthread_detach(thread);
+	}
+	if (Workers > 0 && In_Flight < FILE_JOBS) {
+		Jobs[(Job_Head + Job_Count) % FILE_JOBS] = file;
+		Job_Count++;
+		In_Flight++;
+		pthread_cond_signal(&Job_Ready);
+		ok = TRUE;
+	}
+	pthread_mutex_unlock(&Job_Lock);
+
+	return ok;
+}
+
+static int Take_Done_Job(REBREQ *file)
+{
+	// Remove the request from the done list (lock must be held).
+	int n;
+
+	for (n = 0; n < Done_Count; n++) {
+		if (Done[n] == file) {
+			Done[n] = Done[--Done_Count];
+			In_Flight--;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void Wait_File_Job(REBREQ *file)
+{
+	// Wait for a pending request to finish (e.g. before close).
+	pthread_mutex_lock(&Job_Lock);
+	while (!Take_Done_Job(file)) pthread_cond_wait(&Job_Done, &Job_Lock);
+	pthread_mutex_unlock(&Job_Lock);
+}
+
+#endif
+
+
+/***********************************************************************
+**
+*/	DEVICE_CMD Read_File(REBREQ *file)
+/*
+***********************************************************************/
+{
+	if (GET_FLAG(file->modes, RFM_DIR)) {
+		return Read_Directory(file, (REBREQ*)file->data);
+	}
+
+	if (!file->id) {
+		file->error = -RFE_NO_HANDLE;
+		return DR_ERROR;
+	}
+
+#ifdef HAS_ASYNC_FILE
+	if (GET_FLAG(file->modes, RFM_ASYNC) && Queue_File_Job(file)) return DR_PEND;
+#endif
+
+	return Read_File_Now(file);
+}
+
+
+/***********************************************************************
+**
+*/	DEVICE_CMD Write_File(REBREQ *file)
+/*
+**	Bug?: update file->size value after write !?
+**
+***********************************************************************/
+{
+	if (!file->id) {
+		file->error = -RFE_NO_HANDLE;
+		return DR_ERROR;
+	}
+
+#ifdef HAS_ASYNC_FILE
+	if (GET_FLAG(file->modes, RFM_ASYNC) && Queue_File_Job(file)) return DR_PEND;
+#endif
+
+	return Write_File_Now(file);
+}
+
+
 /***********************************************************************
 **
 */	DEVICE_CMD Query_File(REBREQ *file)
@@ -488,11 +676,38 @@ fail:
 
 /***********************************************************************
 **
-*/	DEVICE_CMD Poll_File(REBREQ *file)
+*/	DEVICE_CMD Poll_File(REBREQ *req)
 /*
+**		Signal the async requests that workers have finished.
+**		Returns TRUE if any were done.
+**
 ***********************************************************************/
 {
-	return DR_DONE;		// files are synchronous (currently)
+#ifdef HAS_ASYNC_FILE
+	REBDEV *dev = (REBDEV*)req; // to keep compiler happy
+	REBREQ *done[FILE_JOBS];
+	REBREQ *file;
+	int count;
+	int n;
+
+	pthread_mutex_lock(&Job_Lock);
+	count = Done_Count;
+	memcpy(done, Done, count * sizeof(REBREQ*));
+	Done_Count = 0;
+	In_Flight -= count;
+	pthread_mutex_unlock(&Job_Lock);
+
+	for (n = 0; n < count; n++) {
+		file = done[n];
+		Detach_Request(&dev->pending, file);
+		if (file->error) Signal_Device(file, EVT_ERROR);
+		else Signal_Device(file, file->command == RDC_WRITE ? EVT_WROTE : EVT_READ);
+	}
+
+	return count > 0;
+#else
+	return DR_DONE;		// files are synchronous
+#endif
 }
 
 
@@ -55,6 +55,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
 #include <time.h>
 #include <string.h>
 
@@ -72,6 +73,23 @@
 // Semaphore lock to sync sub-task launch:
 static void *Task_Ready;
 
+#ifdef HAS_THREADS
+#include <pthread.h>
+
+#define MAX_JOBS 32		// threads used by OS_Run_Jobs
+
+typedef struct host_job {
+	CFUNC job;
+	void *arg;
+} HOST_JOB;
+
+static void *Run_Job(void *job)
+{
+	((HOST_JOB*)job)->job(((HOST_JOB*)job)->arg);
+	return 0;
+}
+#endif
+
 #ifndef PATH_MAX
 #define PATH_MAX 4096  // generally lacking in Posix
 #endif
@@ -180,6 +198,19 @@ static void *Task_Ready;
 }
 
 
+/***********************************************************************
+**
+*/	void OS_Unmap_File(void *data, REBCNT len)
+/*
+**		Release a file mapped by the file device (see RFM_MAP).
+**		The len includes the terminator reserved after the data.
+**
+***********************************************************************/
+{
+	munmap(data, len);
+}
+
+
 /***********************************************************************
 **
 */	void OS_Exit(int code)
@@ -583,6 +614,48 @@ static void *Task_Ready;
 }
 
 
+/***********************************************************************
+**
+*/	void OS_Run_Jobs(CFUNC job, void *args, REBCNT size, REBCNT count)
+/*
+**		Call the job function for each of count argument records
+**		(size bytes apart) at once, on worker threads, and return
+**		when all of them are done. The first record runs on the
+**		calling thread, as do any that could not get a thread.
+**
+**		Jobs must not call into the interpreter; it is not
+**		thread safe.
+**
+***********************************************************************/
+{
+#ifdef HAS_THREADS
+	pthread_t threads[MAX_JOBS];
+	HOST_JOB jobs[MAX_JOBS];
+	REBCNT started[MAX_JOBS];
+	REBCNT n;
+
+	for (n = 1; n < count; n++) {
+		started[n] = FALSE;
+		if (n >= MAX_JOBS) continue;
+		jobs[n].job = job;
+		jobs[n].arg = (char*)args + n * size;
+		started[n] = !pthread_create(&threads[n], 0, Run_Job, &jobs[n]);
+	}
+
+	if (count > 0) job(args);
+
+	for (n = 1; n < count; n++) {
+		if (n < MAX_JOBS && started[n]) pthread_join(threads[n], 0);
+		else job((char*)args + n * size);
+	}
+#else
+	REBCNT n;
+
+	for (n = 0; n < count; n++) job((char*)args + n * size);
+#endif
+}
+
+
 /***********************************************************************
 **
 */	int OS_Create_Process(REBCHR *call, u32 flags)
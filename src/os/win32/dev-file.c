@@ -277,6 +277,33 @@ fail:
 }
 
 
+static BOOL Map_File(REBREQ *file)
+{
+	// Map a file into memory rather than reading it. The view is
+	// copy on write. The unused end of the last page is zero, and
+	// serves as the terminator, so files of an exact page multiple
+	// are not mapped. Returns FALSE if the file cannot be mapped.
+	SYSTEM_INFO info;
+	HANDLE map;
+	void *mem;
+
+	GetSystemInfo(&info);
+	if (file->file.index != 0 || (file->length % info.dwPageSize) == 0) return FALSE;
+	if (GetFileType(file->handle) != FILE_TYPE_DISK) return FALSE;
+
+	map = CreateFileMapping(file->handle, 0, PAGE_WRITECOPY, 0, 0, 0);
+	if (!map) return FALSE;
+	mem = MapViewOfFile(map, FILE_MAP_COPY, 0, 0, file->length);
+	CloseHandle(map); // the view keeps the mapping open
+	if (!mem) return FALSE;
+
+	file->data = mem;
+	file->actual = file->length;
+	file->file.index += file->actual;
+	return TRUE;
+}
+
+
 /***********************************************************************
 **
 */	DEVICE_CMD Read_File(REBREQ *file)
@@ -297,6 +324,15 @@ fail:
 		if (!Seek_File_64(file)) return DR_ERROR;
 	}
 
+	// Map the file, or let the caller do a normal read:
+	if (GET_FLAG(file->modes, RFM_MAP)) {
+		if (!Map_File(file)) {
+			CLR_FLAG(file->modes, RFM_MAP);
+			file->actual = 0;
+		}
+		return DR_DONE;
+	}
+
 	if (!ReadFile(file->handle, file->data, file->length, &file->actual, 0)) {
 		file->error = -RFE_BAD_READ;
 		return DR_ERROR;
@@ -343,6 +379,7 @@ fail:
 			else file->error = -RFE_BAD_WRITE;
 			return DR_ERROR;
 		}
+		file->file.index += file->actual;
 	}
 
 	size_low = GetFileSize(file->handle, &size_high);
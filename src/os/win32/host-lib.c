@@ -63,6 +63,19 @@
 // Semaphore lock to sync sub-task launch:
 static void *Task_Ready;
 
+#define MAX_JOBS 32		// threads used by OS_Run_Jobs
+
+typedef struct host_job {
+	CFUNC job;
+	void *arg;
+} HOST_JOB;
+
+static DWORD WINAPI Run_Job(LPVOID job)
+{
+	((HOST_JOB*)job)->job(((HOST_JOB*)job)->arg);
+	return 0;
+}
+
 
 /***********************************************************************
 **
@@ -174,6 +187,19 @@ static void *Task_Ready;
 }
 
 
+/***********************************************************************
+**
+*/	void OS_Unmap_File(void *data, REBCNT len)
+/*
+**		Release a file mapped by the file device (see RFM_MAP).
+**		The len includes the terminator reserved after the data.
+**
+***********************************************************************/
+{
+	UnmapViewOfFile(data);
+}
+
+
 /***********************************************************************
 **
 */	void OS_Exit(int code)
@@ -561,6 +587,44 @@ static void *Task_Ready;
 }
 
 
+/***********************************************************************
+**
+*/	void OS_Run_Jobs(CFUNC job, void *args, REBCNT size, REBCNT count)
+/*
+**		Call the job function for each of count argument records
+**		(size bytes apart) at once, on worker threads, and return
+**		when all of them are done. The first record runs on the
+**		calling thread, as do any that could not get a thread.
+**
+**		Jobs must not call into the interpreter; it is not
+**		thread safe.
+**
+***********************************************************************/
+{
+	HANDLE threads[MAX_JOBS];
+	HOST_JOB jobs[MAX_JOBS];
+	REBCNT n;
+
+	for (n = 1; n < count; n++) {
+		threads[n] = 0;
+		if (n >= MAX_JOBS) continue;
+		jobs[n].job = job;
+		jobs[n].arg = (char*)args + n * size;
+		threads[n] = CreateThread(0, 0, Run_Job, &jobs[n], 0, 0);
+	}
+
+	if (count > 0) job(args);
+
+	for (n = 1; n < count; n++) {
+		if (n < MAX_JOBS && threads[n]) {
+			WaitForSingleObject(threads[n], INFINITE);
+			CloseHandle(threads[n]);
+		}
+		else job((char*)args + n * size);
+	}
+}
+
+
 /***********************************************************************
 **
 */	int OS_Create_Process(REBCHR *call, u32 flags)
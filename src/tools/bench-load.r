@@ -0,0 +1,69 @@
+REBOL [
+	System: "REBOL [R3] Language Interpreter and Run-time Environment"
+	Title: "LOAD throughput benchmark"
+	Rights: {
+		Copyright 2012 REBOL Technologies
+		REBOL is a trademark of REBOL Technologies
+	}
+	License: {
+		Licensed under the Apache License, Version 2.0
+		See: http://www.apache.org/licenses/LICENSE-2.0
+	}
+	Purpose: {
+		Measures LOAD speed in MB/s on large generated source files.
+		Each kind of file favors one part of the scanner, so builds
+		before and after a scanner change can be compared by kind:
+
+			r3 bench-load.r         ; 32 MB per file
+			r3 bench-load.r 128     ; 128 MB per file
+
+		The files are written to the current directory and deleted
+		when done. Each result is the best of several runs of LOAD
+		on the file data already in memory (so it is not disk speed).
+	}
+]
+
+size: any [attempt [1048576 * to integer! first system/options/args] 32 * 1048576]
+runs: 3
+
+kinds: [
+	"indented" {
+		record [
+			id: 12345
+			; A comment line, as in hand written source files.
+			values: [
+				1.5
+				2.25
+			]
+		]
+}
+	"strings" {
+	text: "A plain ASCII string of some length, as in data files, with no escapes"
+	note: {A braced string that goes on for a while
+		and over two lines of plain text.}
+}
+	"words" {
+	item [id: 12345 name: first rest of the-list a/b/c 1.5 -3 $12.50 10:30 %file.txt]
+}
+]
+
+foreach [kind record] kinds [
+	data: make string! size + 1000
+	while [size > length? data] [append data record]
+	file: join %bench-load- [kind %.tmp]
+	write file data
+	data: read file
+	best: none
+	loop runs [
+		recycle
+		t: now/precise
+		load data
+		t: to decimal! difference now/precise t
+		if any [none? best t < best] [best: t]
+	]
+	delete file
+	print [
+		kind ":" round/to (length? data) / 1048576 0.1 "MB in" round/to best 0.001 "sec ="
+		round/to (length? data) / 1048576 / max best 0.001 0.1 "MB/s"
+	]
+]
@@ -32,6 +32,7 @@ core: [
 	d-dump.c
 	d-print.c
 	f-blocks.c
+	f-dconv.c
 	f-deci.c
 	f-dtoa.c
 	f-enbase.c
@@ -41,6 +42,7 @@ core: [
 	f-qsort.c
 	f-random.c
 	f-round.c
+	f-serial.c
 	f-series.c
 	f-stubs.c
 	l-scan.c
@@ -56,7 +58,9 @@ core: [
 	n-sets.c
 	n-strings.c
 	n-system.c
+	p-checksum.c
 	p-clipboard.c
+	p-compress.c
 	p-console.c
 	p-dir.c
 	p-dns.c
@@ -99,13 +103,16 @@ core: [
 	t-word.c
 	u-bmp.c
 	u-compress.c
+	u-csv.c
 	u-dialect.c
 	u-gif.c
 	u-jpg.c
+	u-json.c
 	u-md5.c
 	u-parse.c
 	u-png.c
 	u-sha1.c
+	u-sha256.c
 	u-zlib.c
 ]
 